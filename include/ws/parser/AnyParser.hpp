@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <ws/parser/ParserCommon.hpp>
+
+namespace ws::parser {
+
+/*
+ * AnyParser<T, Capacity>
+ *    Owning type erased parser of T, like std::function<Result<T>(TokenStream&)> but made for the parsers:
+ *    the parser is stored inline when it fits in Capacity bytes, on the heap otherwise
+ *    A call is a single indirect call, there is no reference counting
+ *    Calling an empty AnyParser, like a Rule never assigned, is a bug caught by an assert
+ */
+template<typename T, std::size_t Capacity = 64>
+class AnyParser {
+public:
+
+    AnyParser() = default;
+
+    template<typename P, typename = std::enable_if_t<!std::is_same_v<std::decay_t<P>, AnyParser>>>
+    AnyParser(P&& p) {
+        using Stored = std::decay_t<P>;
+        if constexpr (fits<Stored>) {
+            object = new (buffer) Stored(std::forward<P>(p));
+            manage = &manage_inline<Stored>;
+        } else {
+            object = new Stored(std::forward<P>(p));
+            manage = &manage_heap<Stored>;
+        }
+        call = &call_stored<Stored>;
+    }
+
+    AnyParser(AnyParser const& other) : call(other.call), manage(other.manage) {
+        if (manage)
+            object = manage(Operation::Copy, buffer, other.object);
+    }
+
+    AnyParser(AnyParser&& other) noexcept : call(other.call), manage(other.manage) {
+        if (manage)
+            object = manage(Operation::Move, buffer, other.object);
+        other.call = nullptr;
+        other.manage = nullptr;
+        other.object = nullptr;
+    }
+
+    AnyParser& operator=(AnyParser const& other) {
+        if (this != &other) {
+            AnyParser copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    AnyParser& operator=(AnyParser&& other) noexcept {
+        if (this != &other) {
+            reset();
+            call = other.call;
+            manage = other.manage;
+            if (manage)
+                object = manage(Operation::Move, buffer, other.object);
+            other.call = nullptr;
+            other.manage = nullptr;
+            other.object = nullptr;
+        }
+        return *this;
+    }
+
+    ~AnyParser() {
+        reset();
+    }
+
+    Result<T> operator()(TokenStream& it) const {
+        assert(call && "AnyParser: no parser held, is it a Rule never assigned?");
+        return call(object, it);
+    }
+
+    explicit operator bool() const {
+        return call != nullptr;
+    }
+
+    // If the parser held is stored inline, without allocation
+    bool is_inline() const {
+        return object == static_cast<void const*>(buffer);
+    }
+
+private:
+
+    enum class Operation {
+        Copy,
+        Move,
+        Destroy
+    };
+
+    using Call = Result<T> (*)(void const*, TokenStream&);
+    using Manage = void* (*)(Operation, void* buffer, void* object);
+
+    template<typename P>
+    static constexpr bool fits = sizeof(P) <= Capacity
+        && alignof(std::max_align_t) % alignof(P) == 0
+        && std::is_nothrow_move_constructible_v<P>;
+
+    template<typename P>
+    static Result<T> call_stored(void const* object, TokenStream& it) {
+        return (*static_cast<P const*>(object))(it);
+    }
+
+    // Copy and move construct into the buffer, the moved parser is destroyed
+
+    template<typename P>
+    static void* manage_inline(Operation operation, void* buffer, void* object) {
+        switch(operation) {
+        case Operation::Copy:
+            return new (buffer) P(*static_cast<P const*>(object));
+        case Operation::Move: {
+            auto moved = new (buffer) P(std::move(*static_cast<P*>(object)));
+            static_cast<P*>(object)->~P();
+            return moved;
+        }
+        default:
+            static_cast<P*>(object)->~P();
+            return nullptr;
+        }
+    }
+
+    // Copy allocates a new parser, move steals the pointer
+
+    template<typename P>
+    static void* manage_heap(Operation operation, void*, void* object) {
+        switch(operation) {
+        case Operation::Copy:
+            return new P(*static_cast<P const*>(object));
+        case Operation::Move:
+            return object;
+        default:
+            delete static_cast<P*>(object);
+            return nullptr;
+        }
+    }
+
+    void reset() {
+        if (manage)
+            manage(Operation::Destroy, buffer, object);
+        call = nullptr;
+        manage = nullptr;
+        object = nullptr;
+    }
+
+    Call call = nullptr;
+    Manage manage = nullptr;
+    void* object = nullptr;
+    alignas(std::max_align_t) unsigned char buffer[Capacity];
+
+};
+
+}
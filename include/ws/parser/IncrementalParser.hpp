@@ -0,0 +1,90 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <ws/parser/token/TokenBuffer.hpp>
+#include <ws/parser/ParserResult.hpp>
+#include <ws/parser/OperatorTable.hpp>
+
+namespace ws::parser {
+
+/*
+ * IncrementalParser
+ *    Parse operator expressions from chunks of tokens, as they arrive, then 'finish' at the end of the stream
+ *    The operators come from an OperatorTable, by default the calculator one, the grammar of ParserEngine
+ *    The operands are floats and parenthesized expressions
+ *    Each token is read once, with one loop iteration per operator whatever the number of precedence levels
+ *    The pending operators and operands live in stacks on the heap, see StackEngine
+ *    The contents are copied where needed, a chunk can be freed once 'feed' returns
+ *    An error is reported by the 'feed' of the first token which can't be parsed, the tokens fed after are ignored
+ *    One parser per stream, 'reset' to parse another one and reuse the memory of the stack
+ *    Once finished, 'reset' is required: 'feed' ignores the tokens and returns false, 'finish' returns an error
+ */
+class IncrementalParser {
+public:
+
+    explicit IncrementalParser(std::size_t max_depth);
+    IncrementalParser(std::shared_ptr<OperatorTable const> table, std::size_t max_depth);
+    ~IncrementalParser();
+
+    IncrementalParser(IncrementalParser&&) noexcept;
+    IncrementalParser& operator=(IncrementalParser&&) noexcept;
+
+    // Returns false once the parse has failed or is finished
+    bool feed(TokenView const& tokens);
+    bool feed(TokenView const& tokens, std::size_t begin, std::size_t end);
+
+    // End of the stream, the AST or the error, the AST is given once
+    ParserResult finish();
+
+    void reset();
+
+    bool has_failed() const;
+    ParserError const* error() const;
+
+    // Number of tokens read so far
+    std::size_t position() const;
+
+private:
+
+    enum class State {
+        Operand,
+        Operator,
+        Failed,
+        Finished
+
+    };
+
+    // A pending prefix or infix operator, or an open parenthesis when 'op' is nullptr
+    struct Frame {
+        Operator const* op;
+    };
+
+    void step(TokenView const& tokens, std::size_t index);
+    void reduce();
+    void reduce_before(Operator const& op);
+    void fail(ParserError const& error);
+    ParserError at_end(ParserError const& error) const;
+    TokenSet after_operand() const;
+
+    std::shared_ptr<OperatorTable const> table;
+    std::size_t depth_budget;
+    State state = State::Operand;
+    std::vector<Frame> frames;
+    std::vector<AST_ptr> operands;
+    std::optional<ParserError> failure;
+    std::size_t consumed = 0;
+
+    // Prefix operators and parenthesis not closed yet, the first ones count in the depth budget
+    std::size_t nesting = 0;
+    std::size_t groups = 0;
+
+    // Line and column just after the last token, for the errors at the end of the stream
+    std::size_t end_line = 1;
+    std::size_t end_column = 1;
+
+};
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <ws/parser/token/Token.hpp>
+#include <ws/parser/token/TokenSet.hpp>
+
+namespace ws::parser {
+
+/*
+ * Operator
+ *    An operator token, and how it binds: the higher the precedence, the tighter
+ *    'name' is the name of the BinaryOperator or UnaryOperator built for it
+ */
+struct Operator {
+    enum class Fixity : std::uint8_t {
+        Prefix,
+        Infix,
+        Postfix
+
+    };
+
+    enum class Associativity : std::uint8_t {
+        Left,
+        Right
+
+    };
+
+    Fixity fixity;
+    unsigned precedence;
+    Associativity associativity;
+    std::string name;
+};
+
+/*
+ * OperatorTable
+ *    Operators of the StackEngine, registered at runtime, indexed by the kind of their token
+ *    A kind can be both a prefix operator and an infix or postfix one, like '-'
+ *    But a kind is either infix or postfix, the last registration wins
+ *    Example:
+ *        OperatorTable table;
+ *        table.infix(TokenType::Operator, TokenSubType::Plus, 1, Operator::Associativity::Left, "plus")
+ *             .prefix(TokenType::Operator, TokenSubType::Minus, 3, "negate");
+ */
+class OperatorTable {
+public:
+
+    OperatorTable& prefix(TokenType type, TokenSubType subtype, unsigned precedence, std::string const& name);
+    OperatorTable& infix(TokenType type, TokenSubType subtype, unsigned precedence, Operator::Associativity associativity, std::string const& name);
+    OperatorTable& postfix(TokenType type, TokenSubType subtype, unsigned precedence, std::string const& name);
+
+    // The grammar of ParserEngine: '+' '-' then '*' '/' all left associative, then the prefix '-'
+    static OperatorTable calculator();
+
+    // The operator of the kind where an operand is expected, or nullptr
+    Operator const* prefix_of(TokenKind kind) const;
+
+    // The operator of the kind after an operand, or nullptr
+    Operator const* infix_or_postfix_of(TokenKind kind) const;
+
+    TokenSet prefixes() const;
+    TokenSet infixes_and_postfixes() const;
+
+private:
+
+    std::array<std::optional<Operator>, token_kind_count> prefix_operators;
+    std::array<std::optional<Operator>, token_kind_count> other_operators;
+    TokenSet prefix_set;
+    TokenSet other_set;
+
+};
+
+}
@@ -1,12 +1,11 @@
 #pragma once
 
-#include <vector>
-
-#include <ws/parser/token/Token.hpp>
+#include <ws/parser/token/TokenBuffer.hpp>
 #include <ws/parser/ParserResult.hpp>
 
 namespace ws::parser {
 
-ParserResult parse(std::vector<Token> const& tokens);
+ParserResult parse(TokenView const& tokens);
+ParserResult parse(TokenView const& tokens, std::size_t begin, std::size_t end);
 
 }
\ No newline at end of file
@@ -0,0 +1,571 @@
+#pragma once
+
+#include <tuple>
+#include <vector>
+#include <optional>
+#include <variant>
+#include <memory>
+#include <string>
+#include <atomic>
+#include <cassert>
+#include <utility>
+
+#include <ws/parser/ParserResult.hpp>
+#include <ws/parser/ParserContext.hpp>
+#include <ws/parser/ParserTrace.hpp>
+#include <ws/parser/token/TokenStream.hpp>
+#include <ws/parser/token/Token.hpp>
+#include <ws/parser/token/TokenRef.hpp>
+
+#include <module/module.h>
+
+namespace ws::parser {
+
+/*
+ * Shared by every combinator family:
+ *    Result<T>, has_failed, the tuple/variant flattening helpers, the memo tables, the tracing of 'log' and the operator<< used to print parsed values
+ */
+
+
+
+
+
+/*
+ * Internal Helpers
+ */
+
+namespace internal {
+
+
+
+
+
+template<typename T>
+struct is_tuple : std::bool_constant<false> {};
+
+template<typename...Ts>
+struct is_tuple<std::tuple<Ts...>> : std::bool_constant<true> {};
+
+template<typename T>
+constexpr auto is_tuple_v = is_tuple<T>::value;
+
+
+
+
+
+// Combine::combine will put both type in a tuple, nested tuples will be flatten
+
+template<typename A, typename B, bool = is_tuple_v<A>, bool = is_tuple_v<B>>
+struct Combine;
+
+template<typename A, typename B>
+struct Combine<A, B, false, false> {
+    using type = std::tuple<A, B>;
+    static type combine(A&& a, B&& b) {
+        return type { std::move(a), std::move(b) };
+    }
+};
+
+template<typename...Args, typename...Brgs>
+struct Combine<std::tuple<Args...>, std::tuple<Brgs...>, true, true> {
+    using type = std::tuple<Args..., Brgs...>;
+    static type combine(std::tuple<Args...>&& a, std::tuple<Brgs...>&& b) {
+        return type { std::move(std::get<Args>(a))..., std::move(std::get<Brgs>(b))... };
+    }
+};
+
+template<typename...Args, typename B>
+struct Combine<std::tuple<Args...>, B, true, false> {
+    using type = std::tuple<Args..., B>;
+    static type combine(std::tuple<Args...>&& a, B&& b) {
+        return type { std::move(std::get<Args>(a))..., std::move(b) };
+    }
+};
+
+template<typename...Args, typename B>
+struct Combine<B, std::tuple<Args...>, false, true> {
+    using type = std::tuple<B, Args...>;
+    static type combine(B&& b, std::tuple<Args...>&& a) {
+        return type { std::move(b), std::move(std::get<Args>(a))... };
+    }
+};
+
+template<typename A, typename B>
+using Combine_t = typename Combine<A, B>::type;
+
+
+
+
+
+template<typename T>
+struct is_variant : std::bool_constant<false> {};
+
+template<typename...Ts>
+struct is_variant<std::variant<Ts...>> : std::bool_constant<true> {};
+
+template<typename T>
+constexpr auto is_variant_v = is_variant<T>::value;
+
+
+
+
+
+// Create a bigger variant from another
+// 'V' is the target variant
+// 'I' is the starting index, should be 0 at the start
+// 'Offset' between the target variant and the current variant, use in 'std::in_place_index<I + Offset>'
+// 'Ts...' are the types in the source variant
+
+template<typename V, std::size_t I, size_t Offset, typename...Ts>
+V create_variant(std::variant<Ts...>&& v) {
+    if constexpr (I + 1 < sizeof...(Ts))
+        if (v.index() != I)
+            return create_variant<V, I + 1, Offset, Ts...>(std::move(v));
+    return V { std::in_place_index<I + Offset>, std::move(std::get<I>(v)) };
+}
+
+
+
+
+
+// Either::left or Either::right will construct the variant<A, B>, any nested variants will be flatten
+
+template<typename A, typename B, bool = is_variant_v<A>, bool = is_variant_v<B>>
+struct Either;
+
+template<typename A, typename B>
+struct Either<A, B, false, false> {
+    using type = std::variant<A, B>;
+    static type left(A&& a) {
+        return type { std::in_place_index<0>, std::move(a) };
+    }
+    static type right(B&& b) {
+        return type { std::in_place_index<1>, std::move(b) };
+    }
+};
+
+template<typename...Args, typename B>
+struct Either<std::variant<Args...>, B, true, false> {
+    using type = std::variant<Args..., B>;
+
+    static type left(std::variant<Args...>&& a) {
+        return create_variant<type, 0, 0, Args...>(std::move(a));
+    }
+    static type right(B&& b) {
+        return type { std::in_place_index<sizeof...(Args)>, std::move(b) };
+    }
+};
+
+template<typename A, typename...Brgs>
+struct Either<A, std::variant<Brgs...>, false, true> {
+    using type = std::variant<A, Brgs...>;
+
+    static type left(A&& a) {
+        return type { std::in_place_index<0>, std::move(a) };
+    }
+    static type right(std::variant<Brgs...>&& b) {
+        return create_variant<type, 0, 1, Brgs...>(std::move(b));
+    }
+};
+
+template<typename...Args, typename...Brgs>
+struct Either<std::variant<Args...>, std::variant<Brgs...>, true, true> {
+    using type = std::variant<Args..., Brgs...>;
+
+    static type left(std::variant<Args...>&& a) {
+        return create_variant<type, 0, 0, Args...>(std::move(a));
+    }
+    static type right(std::variant<Brgs...>&& b) {
+        return create_variant<type, 0, sizeof...(Args), Brgs...>(std::move(b));
+    }
+};
+
+template<typename A, typename B>
+using Either_t = typename Either<A, B>::type;
+
+
+
+
+
+// Pass all elements of the tuple to the function
+
+template<typename F, typename T, size_t...Is >
+decltype(auto) apply_tuple(F&& f, T t, std::index_sequence<Is...>) {
+  return std::forward<F>(f)(std::move(std::get<Is>(t))...);
+}
+
+
+
+
+
+template<typename...Ts, std::size_t...Is>
+std::ostream& print_tuple(std::ostream& os, std::tuple<Ts...> const& tuple, std::index_sequence<Is...>) {
+    (std::initializer_list<int>){((os << (Is == 0 ? "" : ", ") << std::get<Is>(tuple)), 0)...};
+    return os;
+}
+
+
+
+
+
+};
+
+
+
+
+
+/*
+ * General definitions
+ */
+
+template<typename T>
+using Result = std::variant<ParserError, T>;
+
+
+
+
+
+template<typename T>
+bool has_failed(Result<T> const& r) {
+    return std::holds_alternative<ParserError>(r);
+}
+
+// A committed failure is never backtracked, the alternatives, loops and optionals return it as it is
+
+template<typename T>
+bool is_committed(Result<T> const& r) {
+    return has_failed(r) && std::get<ParserError>(r).is_committed();
+}
+
+
+
+
+
+namespace internal {
+
+// Run the parser, if it fails rollback the stream where it was, still returns what the parser returned
+// Used inline by the backtracking combinators of both families, no parser is built at parse time
+
+template<typename P>
+auto attempt(P const& p, TokenStream& it) -> decltype(p(it)) {
+    auto backup = it;
+    auto res = p(backup);
+    if (!has_failed(res))
+        it = backup;
+    return res;
+}
+
+}
+
+
+
+
+
+namespace internal {
+
+// The tokens were expected at the current position, or 'offset' tokens after it, the context of the stream keeps the furthest failure
+
+inline void expect(TokenStream const& it, TokenSet tokens, std::size_t offset = 0) {
+    if (auto* context = it.context(); context)
+        context->expect(tokens, it.position() + offset);
+}
+
+inline ParserError fail(TokenStream const& it, TokenSet tokens, std::size_t offset = 0) {
+    expect(it, tokens, offset);
+    return ParserError::expected(tokens, it.position() + offset);
+}
+
+// Run the parser on a copy of the stream for a lookahead, the tokens it expects are not recorded by the context:
+// a probe that fails is not a failure of the parse, the lookahead decides what is required
+
+class SuspendedExpectations {
+public:
+
+    explicit SuspendedExpectations(ParserContext* context) : context(context) {
+        if (context)
+            context->suspend_expectations();
+    }
+
+    ~SuspendedExpectations() {
+        if (context)
+            context->resume_expectations();
+    }
+
+    SuspendedExpectations(SuspendedExpectations const&) = delete;
+    SuspendedExpectations& operator=(SuspendedExpectations const&) = delete;
+
+private:
+
+    ParserContext* context;
+
+};
+
+template<typename P>
+auto probe(P const& p, TokenStream const& it) -> decltype(p(std::declval<TokenStream&>())) {
+    SuspendedExpectations suspended(it.context());
+    auto copy = it;
+    return p(copy);
+}
+
+}
+
+
+
+
+
+
+/*
+ * Memoization, used by 'memo'
+ */
+
+namespace internal {
+
+
+
+
+
+// Each memoized rule has its own id, the copies of a memoized rule share it
+
+inline std::size_t next_memo_id() {
+    static std::atomic<std::size_t> id = 0;
+    return id++;
+}
+
+
+
+
+
+// The memo table keeps its own copy of the result, std::unique_ptr are cloned
+
+template<typename T>
+struct is_unique_ptr : std::bool_constant<false> {};
+
+template<typename T>
+struct is_unique_ptr<std::unique_ptr<T>> : std::bool_constant<true> {};
+
+template<typename T>
+T memo_copy(T const& value) {
+    if constexpr (is_unique_ptr<T>::value)
+        return value ? value->clone() : nullptr;
+    else
+        return value;
+}
+
+template<typename T>
+Result<T> memo_copy(Result<T> const& r) {
+    if (has_failed(r))
+        return std::get<ParserError>(r);
+    return memo_copy(std::get<1>(r));
+}
+
+
+
+
+
+// Results of a rule for each position of the stream
+
+template<typename T>
+class MemoTable : public MemoTableBase {
+public:
+
+    struct Entry {
+        Result<T> result;
+        TokenStream after;
+    };
+
+    explicit MemoTable(std::size_t size) : entries(size) {}
+
+    std::optional<Entry>& at(std::size_t position) {
+        return entries[position];
+    }
+
+private:
+
+    std::vector<std::optional<Entry>> entries;
+
+};
+
+
+
+
+
+// Run the parser through the memo table of the rule, if the context of the stream enables packrat parsing
+
+template<typename T, typename P>
+Result<T> memoize(std::size_t rule_id, TokenStream& it, P const& p) {
+    auto* context = it.context();
+    if (context == nullptr || !context->is_packrat())
+        return p(it);
+
+    auto* table = static_cast<MemoTable<T>*>(context->memo_table(rule_id));
+    if (table == nullptr)
+        table = static_cast<MemoTable<T>*>(&context->set_memo_table(rule_id, std::make_unique<MemoTable<T>>(it.size() + 1)));
+
+    auto& entry = table->at(it.position());
+    if (entry) {
+        context->memo_hit();
+        it = entry->after;
+        return memo_copy(entry->result);
+    }
+
+    context->memo_miss();
+    auto res = p(it);
+    entry.emplace(typename MemoTable<T>::Entry { memo_copy(res), it });
+    return res;
+}
+
+
+
+
+
+}
+
+
+
+
+
+/*
+ * operator<< for
+ *    std::tuple
+ *    std::optional
+ *    std::unique_ptr
+ *    std::variant
+ *    std::vector
+ */
+
+
+
+
+
+template<typename...Ts>
+std::ostream& operator<<(std::ostream& os, std::tuple<Ts...> const& tuple) {
+    os << "<";
+    return internal::print_tuple(os, tuple, std::make_index_sequence<sizeof...(Ts)>()) << ">";
+}
+
+
+
+
+
+template<typename T>
+std::ostream& operator<<(std::ostream& os, std::vector<T> const& vector) {
+    bool first = true;
+    os << "[";
+    for(auto const& t : vector) {
+        if (!first)
+            os << ", ";
+        os << t;
+        first = false;
+    }
+    return os << "]";
+}
+
+
+
+
+
+template<typename T>
+std::ostream& operator<<(std::ostream& os, std::unique_ptr<T> const& ptr) {
+    return os << "*" << *ptr;
+}
+
+
+
+
+
+template<typename T>
+std::ostream& operator<<(std::ostream& os, std::optional<T> const& opt) {
+    if (opt)
+        return os << "$" << *opt;
+    return os << "$null";
+}
+
+
+
+
+
+template<typename...Ts>
+std::ostream& operator<<(std::ostream& os, std::variant<Ts...> const& variant) {
+    os << "|" << variant.index() << ": ";
+    return std::visit([&os] (auto const& v) -> std::ostream& { return os << v; }, variant) << "|";
+}
+
+
+
+
+/*
+ * Tracing, used by 'log'
+ */
+
+namespace internal {
+
+
+
+
+
+// Print the value of a TraceValue, only called if the sink prints it
+
+template<typename T>
+void print_value(std::ostream& os, void const* object) {
+    os << *static_cast<T const*>(object);
+}
+
+inline void print_error(std::ostream& os, void const* object) {
+    os << static_cast<ParserError const*>(object)->what();
+}
+
+
+
+
+
+// Run the parser between the Begin and the Success/Failure events, nested rules are one level deeper
+
+template<typename T, typename P>
+Result<T> trace(TraceSink& sink, std::size_t& depth, std::string const& name, TokenStream& it, P const& p) {
+    auto level = static_cast<std::uint32_t>(depth);
+    sink.record({TraceEvent::Kind::Begin, level, it.position(), &name}, {});
+    ++depth;
+    try {
+        auto res = p(it);
+        --depth;
+
+        if (has_failed(res))
+            sink.record({TraceEvent::Kind::Failure, level, it.position(), &name}, {&std::get<ParserError>(res), print_error});
+        else
+            sink.record({TraceEvent::Kind::Success, level, it.position(), &name}, {&std::get<1>(res), print_value<T>});
+
+        return res;
+    } catch(...) {
+        --depth;
+        sink.record({TraceEvent::Kind::Exception, level, it.position(), &name}, {});
+        throw;
+    }
+}
+
+
+
+
+
+// Trace the parser only if the tracing is compiled and the context of the stream has a sink
+
+template<typename T, typename P>
+Result<T> traced(std::string const& name, TokenStream& it, P const& p) {
+    if constexpr (trace_compiled) {
+        auto* context = it.context();
+        if (context != nullptr && context->trace_sink() != nullptr)
+            return trace<T>(*context->trace_sink(), context->trace_depth(), name, it, p);
+    }
+    return p(it);
+}
+
+
+
+
+
+}
+
+
+
+
+
+}
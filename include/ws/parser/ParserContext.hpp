@@ -0,0 +1,87 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <ws/parser/ParserResult.hpp>
+
+namespace ws::parser {
+
+class TraceSink;
+
+namespace internal {
+
+// Memo table of a single rule, see 'memo' in ParserCommon.hpp
+
+class MemoTableBase {
+public:
+    virtual ~MemoTableBase() = default;
+};
+
+}
+
+/*
+ * ParserContext
+ *    State of a single parse, reachable from the TokenStream
+ *    Create one per thread, it can be reused for several parses
+ *
+ *    packrat: enable the memo tables of the 'memo' combinators, each memoized rule is then run at most once per token
+ *             a table is only made for a rule run with this context, it is dropped at the next parse
+ *             the counters of hits and misses are accumulated over all the parses done with this context
+ *             the grammars of the engines are predictive and do not use 'memo', it is for the grammars that backtrack
+ *
+ *    trace sink: receive the events of the 'log' combinators, none by default, see ParserTrace.hpp
+ *
+ *    nesting depth: the levels opened by the 'nested' combinators, see ParserStatic.hpp
+ *
+ *    furthest failure: the furthest position where a token was expected, and every token expected there,
+ *                      it becomes the error of the parse
+ *                      the lookaheads suspend it while they probe the stream, what they try is not required
+ */
+class ParserContext {
+public:
+
+    explicit ParserContext(bool packrat = false);
+
+    bool is_packrat() const;
+
+    std::size_t memo_hits() const;
+    std::size_t memo_misses() const;
+
+    void begin_parse();
+
+    internal::MemoTableBase* memo_table(std::size_t rule_id) const;
+    internal::MemoTableBase& set_memo_table(std::size_t rule_id, std::unique_ptr<internal::MemoTableBase> table);
+
+    void memo_hit();
+    void memo_miss();
+
+    TraceSink* trace_sink() const;
+    void set_trace_sink(TraceSink* sink);
+    std::size_t& trace_depth();
+
+    std::size_t& nesting_depth();
+
+    void expect(TokenSet tokens, std::size_t position);
+    void suspend_expectations();
+    void resume_expectations();
+    ParserError furthest_failure() const;
+
+private:
+
+    bool packrat;
+    TraceSink* sink = nullptr;
+    std::size_t depth = 0;
+    std::size_t nesting = 0;
+    std::size_t failure_position = 0;
+    std::size_t suspended = 0;
+    TokenSet failure_expected;
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    // Only the tables of the rules run with this context, searched by id, a grammar has few memoized rules
+    std::vector<std::pair<std::size_t, std::unique_ptr<internal::MemoTableBase>>> memo_tables;
+
+};
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <ws/parser/token/TokenBuffer.hpp>
+#include <ws/parser/ParserResult.hpp>
+#include <ws/parser/ParserContext.hpp>
+
+namespace ws::parser {
+
+/*
+ * ParserEngine
+ *    Build the grammar once, then parse as many token streams as needed with it
+ *    The grammar is immutable once built, so a single engine can be shared between threads
+ *    The state of a parse lives in a ParserContext, one per thread, see ParserContext.hpp for the options
+ *    The grammar is recursive, each '(' and each prefix '-' takes about 2 KiB of the thread stack,
+ *    so the nesting is limited by a budget, over it the parse fails with TooDeep like StackEngine
+ *    Prefer StackEngine for untrusted input, this engine is the one that can be traced and profiled
+ */
+class ParserEngine {
+public:
+
+    static constexpr std::size_t default_max_depth = 1000;
+
+    explicit ParserEngine(std::size_t max_depth = default_max_depth);
+    ~ParserEngine();
+
+    ParserEngine(ParserEngine&&) noexcept;
+    ParserEngine& operator=(ParserEngine&&) noexcept;
+
+    std::size_t max_depth() const;
+
+    ParserResult parse(TokenView const& tokens) const;
+    ParserResult parse(TokenView const& tokens, ParserContext& context) const;
+
+    // A slice [begin, end) of the tokens, without copy
+    ParserResult parse(TokenView const& tokens, std::size_t begin, std::size_t end) const;
+    ParserResult parse(TokenView const& tokens, std::size_t begin, std::size_t end, ParserContext& context) const;
+
+private:
+
+    struct Grammar;
+
+    std::unique_ptr<Grammar const> grammar;
+    std::size_t depth_budget;
+
+};
+
+}
@@ -1,15 +1,8 @@
 #pragma once
 
-#include <tuple>
-#include <vector>
-#include <optional>
-#include <variant>
+#include <functional>
 
-#include <ws/parser/ParserResult.hpp>
-#include <ws/parser/token/TokenStream.hpp>
-#include <ws/parser/token/Token.hpp>
-
-#include <module/module.h>
+#include <ws/parser/ParserCommon.hpp>
 
 namespace ws::parser {
 
@@ -21,8 +14,14 @@ namespace ws::parser {
 
  * Parser:
 
- * eat (TokenType, TokenSubType) -> Parser<Token>
- *    Comsume the next token of the stream if the type/subtype match, or returns an error, the stream is always comsumed
+ * eat (TokenKind) -> Parser<TokenRef>
+ * eat (TokenType, TokenSubType) -> Parser<TokenRef>
+ *    Consume the next token of the stream if the kind match, or returns an error, a failed eat leaves the stream where it was
+ *    The token is returned by reference into the input, it is never copied
+ *    The end of the stream is a normal failure, no exception is thrown
+
+ * one_of (TokenSet) -> Parser<TokenRef>
+ *    Equivalent of 'join(eat(...) | eat(...) | ...)' in a single mask test, returns the matched token
 
  * try_ (Parser<A>) -> Parser<A>
  *    Try to run the parser, if it fails rollback the stream where it was, still returns what the parser returned
@@ -35,16 +34,24 @@ namespace ws::parser {
 
  * operator | (Parser<A>, Parser<B>) -> Parser<std::variant<A, B>>
  *    Run the first parser, if it fails run the second parser, if it fails returns an error
+ *    A committed failure of the first parser is returned without running the second one
  *    Note:
  *        If A or B is a variant, it will concatenate the variant
  *        So operator | (Parser<std::variant<A, B>>, Parser<std::variant<C, A>>) -> Parser<std::variant<A, B, C, A>>
 
  * many (Parser<A>) -> Parser<std::vector<A>>
- *    Accumulate the result of the parser until it fails, this parser never fails, since it can returns an empty vector
+ *    Accumulate the result of the parser until it fails, this parser only fails on a committed failure
+ *    An iteration that consumes nothing, like a lookahead, is the last one: it would succeed forever
 
  * some (Parser<A>) -> Parser<std::tuple<A, std::vector<A>>>
  *    Combination of itself and many, will parse A at least once, if the first iteration fails, an error is resturned
 
+ * chainl1 (Parser<A>, Parser<O>, A(A, O, A)) -> Parser<A>
+ *    Parse 'A (O A)*' and fold it from the left while parsing: fold(fold(a1, o1, a2), o2, a3)...
+
+ * chainr1 (Parser<A>, Parser<O>, A(A, O, A)) -> Parser<A>
+ *    Parse 'A (O A)*' and fold it from the right: fold(a1, o1, fold(a2, o2, a3))...
+
  * operator ~ (Parser<A>) -> Parser<A>
  *    Equivalent of 'ref'
 
@@ -55,7 +62,20 @@ namespace ws::parser {
  *    Equivalent of 'a & b' but discard the first result
 
  * optional (Parser<A>) -> Parser<std::optional<A>>
- *    Run the parser, if it fails return an empty optional, can't fail
+ *    Run the parser, if it fails return an empty optional, only fails on a committed failure
+
+ * commit (Parser<A>) -> Parser<A>
+ *    Cut: run the parser, if it fails the error is committed and nothing backtracks over it anymore, the whole parse fails
+ *    Use it once the tokens already consumed leave no other choice, like after a '('
+
+ * peek (Parser<A>) -> Parser<std::monostate>
+ *    Run the parser on a copy of the stream, succeed if it succeeds, nothing is consumed and its result is dropped
+
+ * not_ (Parser<A>) -> Parser<std::monostate>
+ *    Run the parser on a copy of the stream, succeed if it fails, nothing is consumed
+
+ * lookahead (std::size_t, TokenSet) -> Parser<std::monostate>
+ *    Succeed if the n-th next token is one of the set, lookahead(1, ...) tests the next token, nothing is consumed nor copied
 
  * ref (Parser<A>) -> Parser<A>
  *    By default parser are copied, but when you need recursion, you have to declare the parser first then referenced it with ref(parser)
@@ -69,11 +89,15 @@ namespace ws::parser {
  * mapI (B(A...), Parser<std::tuple<A...>>) -> Parser<B>
  *    Equivalent of 'map' but unpack each element of a tuple
 
+ * memo (Parser<A>) -> Parser<A>
+ *    Packrat memoization, when the ParserContext of the stream enables it, the parser is run at most once per token and the result is reused
+
  * log (std::string, Parser<A>) -> Parser<A>
- *    Print a message when the parser is run, and when it succed/fail, returns the result of that parser, the type A need to implement operato<<(std::ostream&)
+ *    Trace when the parser is run, and when it succed/fail, to the TraceSink of the ParserContext, returns the result of that parser
+ *    Compiled out when WS_PARSER_TRACE is 0, the type A need to implement operato<<(std::ostream&)
 
  * log (std::size_t&, std::string, Parser<A>) -> Parser<A>
- *    Equivalent of log but will use spaces to indent the code, it also increament it for the future logs
+ *    Equivalent of log but the depth of the events is counted in the given variable
 
  * join (Parser<std::variant<A...>>) -> Parser<B>
  *    Run the parser and convert the result into B, All types in the variant need to be convertible to B
@@ -84,197 +108,10 @@ namespace ws::parser {
 
 
 
-/*
- * Internal Helpers
- */
-
-namespace internal {
-
-
-
-
-
-template<typename T>
-struct is_tuple : std::bool_constant<false> {};
-
-template<typename...Ts>
-struct is_tuple<std::tuple<Ts...>> : std::bool_constant<true> {};
-
-template<typename T>
-constexpr auto is_tuple_v = is_tuple<T>::value;
-
-
-
-
-
-// Combine::combine will put both type in a tuple, nested tuples will be flatten
-
-template<typename A, typename B, bool = is_tuple_v<A>, bool = is_tuple_v<B>>
-struct Combine;
-
-template<typename A, typename B>
-struct Combine<A, B, false, false> {
-    using type = std::tuple<A, B>;
-    static type combine(A&& a, B&& b) {
-        return type { std::move(a), std::move(b) };
-    }
-};
-
-template<typename...Args, typename...Brgs>
-struct Combine<std::tuple<Args...>, std::tuple<Brgs...>, true, true> {
-    using type = std::tuple<Args..., Brgs...>;
-    static type combine(std::tuple<Args...>&& a, std::tuple<Brgs...>&& b) {
-        return type { std::move(std::get<Args>(a))..., std::move(std::get<Brgs>(b))... };
-    }
-};
-
-template<typename...Args, typename B>
-struct Combine<std::tuple<Args...>, B, true, false> {
-    using type = std::tuple<Args..., B>;
-    static type combine(std::tuple<Args...>&& a, B&& b) {
-        return type { std::move(std::get<Args>(a))..., std::move(b) };
-    }
-};
-
-template<typename...Args, typename B>
-struct Combine<B, std::tuple<Args...>, false, true> {
-    using type = std::tuple<B, Args...>;
-    static type combine(B&& b, std::tuple<Args...>&& a) {
-        return type { std::move(b), std::move(std::get<Args>(a))... };
-    }
-};
-
-template<typename A, typename B>
-using Combine_t = typename Combine<A, B>::type;
-
-
-
-
-
-template<typename T>
-struct is_variant : std::bool_constant<false> {};
-
-template<typename...Ts>
-struct is_variant<std::variant<Ts...>> : std::bool_constant<true> {};
-
-template<typename T>
-constexpr auto is_variant_v = is_variant<T>::value;
-
-
-
-
-
-// Create a bigger variant from another
-// 'V' is the target variant
-// 'I' is the starting index, should be 0 at the start
-// 'Offset' between the target variant and the current variant, use in 'std::in_place_index<I + Offset>'
-// 'Ts...' are the types in the source variant
-
-template<typename V, std::size_t I, size_t Offset, typename...Ts>
-V create_variant(std::variant<Ts...>&& v) {
-    if constexpr (I + 1 < sizeof...(Ts))
-        if (v.index() != I)
-            return create_variant<V, I + 1, Offset, Ts...>(std::move(v));
-    return V { std::in_place_index<I + Offset>, std::move(std::get<I>(v)) };
-}
-
-
-
-
-
-// Either::left or Either::right will construct the variant<A, B>, any nested variants will be flatten
-
-template<typename A, typename B, bool = is_variant_v<A>, bool = is_variant_v<B>>
-struct Either;
-
-template<typename A, typename B>
-struct Either<A, B, false, false> {
-    using type = std::variant<A, B>;
-    static type left(A&& a) {
-        return type { std::in_place_index<0>, std::move(a) };
-    }
-    static type right(B&& b) {
-        return type { std::in_place_index<1>, std::move(b) };
-    }
-};
-
-template<typename...Args, typename B>
-struct Either<std::variant<Args...>, B, true, false> {
-    using type = std::variant<Args..., B>;
-
-    static type left(std::variant<Args...>&& a) {
-        return create_variant<type, 0, 0, Args...>(std::move(a));
-    }
-    static type right(B&& b) {
-        return type { std::in_place_index<sizeof...(Args)>, std::move(b) };
-    }
-};
-
-template<typename A, typename...Brgs>
-struct Either<A, std::variant<Brgs...>, false, true> {
-    using type = std::variant<A, Brgs...>;
-
-    static type left(A&& a) {
-        return type { std::in_place_index<0>, std::move(a) };
-    }
-    static type right(std::variant<Brgs...>&& b) {
-        return create_variant<type, 0, 1, Brgs...>(std::move(b));
-    }
-};
-
-template<typename...Args, typename...Brgs>
-struct Either<std::variant<Args...>, std::variant<Brgs...>, true, true> {
-    using type = std::variant<Args..., Brgs...>;
-
-    static type left(std::variant<Args...>&& a) {
-        return create_variant<type, 0, 0, Args...>(std::move(a));
-    }
-    static type right(std::variant<Brgs...>&& b) {
-        return create_variant<type, 0, sizeof...(Args), Brgs...>(std::move(b));
-    }
-};
-
-template<typename A, typename B>
-using Either_t = typename Either<A, B>::type;
-
-
-
-
-
-// Pass all elements of the tuple to the function
-
-template<typename F, typename T, size_t...Is >
-decltype(auto) apply_tuple(F&& f, T t, std::index_sequence<Is...>) {
-  return std::forward<F>(f)(std::move(std::get<Is>(t))...);
-}
-
-
-
-
-
-template<typename...Ts, std::size_t...Is>
-std::ostream& print_tuple(std::ostream& os, std::tuple<Ts...> const& tuple, std::index_sequence<Is...>) {
-    (std::initializer_list<int>){((os << (Is == 0 ? "" : ", ") << std::get<Is>(tuple)), 0)...};
-    return os;
-}
-
-
-
-
-
-};
-
-
-
-
-
 /*
  * General definitions
  */
 
-template<typename T>
-using Result = std::variant<ParserError, T>;
-
 template<typename T>
 using Parser = std::function<Result<T>(TokenStream&)>; 
 
@@ -282,15 +119,6 @@ using Parser = std::function<Result<T>(TokenStream&)>;
 
 
 
-template<typename T>
-bool has_failed(Result<T> const& r) {
-    return std::holds_alternative<ParserError>(r);
-}
-
-
-
-
-
 /*
  * try_ (Parser<A>) -> Parser<A>
  *    Try to run the parser, if it fails rollback the stream where it was, still returns what the parser returned
@@ -298,16 +126,7 @@ bool has_failed(Result<T> const& r) {
 template<typename T>
 Parser<T> try_(Parser<T> const& p) {
     return [=] (TokenStream& it) -> Result<T> {
-        try {
-            auto backup = it;
-            auto res = p(backup);
-            if (!has_failed(res)) {
-                it = backup;
-            }
-            return std::move(res);
-        } catch (std::out_of_range&) {
-            return ParserError::error();
-        }
+        return internal::attempt(p, it);
     };
 }
 
@@ -327,11 +146,11 @@ Parser<typename internal::Combine<A, B>::type> operator & (Parser<A> const& pa,
     return [=] (TokenStream& it) -> Result<typename internal::Combine<A, B>::type> { 
         auto a = pa(it);
         if (has_failed(a))
-            return ParserError::error();
+            return std::get<ParserError>(a);
 
         auto b = pb(it);
         if (has_failed(b))
-            return ParserError::error();
+            return std::get<ParserError>(b);
 
         return internal::Combine<A, B>::combine(std::move(std::get<A>(a)), std::move(std::get<B>(b)));
     };
@@ -351,17 +170,19 @@ Parser<typename internal::Combine<A, B>::type> operator & (Parser<A> const& pa,
 template<typename A, typename B>
 Parser<typename internal::Either<A, B>::type> operator | (Parser<A> const& pa, Parser<B> const& pb) {
     return [=] (TokenStream& it) -> Result<typename internal::Either<A, B>::type> { 
-        auto a = try_(pa)(it);
+        auto a = internal::attempt(pa, it);
 
         if (!has_failed(a))
             return internal::Either<A, B>::left(std::move(std::get<A>(a)));
+        if (is_committed(a))
+            return std::get<ParserError>(a);
 
-        auto b = try_(pb)(it);
+        auto b = internal::attempt(pb, it);
 
         if (!has_failed(b))
             return internal::Either<A, B>::right(std::move(std::get<B>(b)));
 
-        return ParserError::error();
+        return std::get<ParserError>(b);
     };
 }
 
@@ -406,17 +227,41 @@ Parser<std::invoke_result_t<F, Ts...>> mapI(F && f, Parser<std::tuple<Ts...>> co
 
 
 /*
- * eat (TokenType, TokenSubType) -> Parser<Token>
- *    Comsume the next token of the stream if the type/subtype match, or returns an error, the stream is always comsumed
+ * eat (TokenKind) -> Parser<TokenRef>
+ * eat (TokenType, TokenSubType) -> Parser<TokenRef>
+ *    Consume the next token of the stream if the kind match, or returns an error, a failed eat leaves the stream where it was
+ */
+inline Parser<TokenRef> eat(TokenKind kind) {
+    return [=] (TokenStream& it) -> Result<TokenRef> {
+        if (TokenSet::of(kind).intersects(it.peek())) {
+            auto t = it.token();
+            ++it;
+            return t;
+        }
+        return internal::fail(it, TokenSet::of(kind));
+    };
+}
+
+inline Parser<TokenRef> eat(TokenType type, TokenSubType subtype) {
+    return eat(kind_of(type, subtype));
+}
+
+
+
+
+
+/*
+ * one_of (TokenSet) -> Parser<TokenRef>
+ *    Equivalent of 'join(eat(...) | eat(...) | ...)' in a single mask test, returns the matched token
  */
-Parser<Token> eat(TokenType type, TokenSubType subtype) {
-    return [=] (TokenStream& it) -> Result<Token> {
-        auto t = *it;
-        if (t.type == type && t.subtype == subtype) {
+inline Parser<TokenRef> one_of(TokenSet kinds) {
+    return [=] (TokenStream& it) -> Result<TokenRef> {
+        if (kinds.intersects(it.peek())) {
+            auto t = it.token();
             ++it;
             return t;
         }
-        return ParserError::error();
+        return internal::fail(it, kinds);
     };
 }
 
@@ -426,17 +271,23 @@ Parser<Token> eat(TokenType type, TokenSubType subtype) {
 
 /*
  * many (Parser<A>) -> Parser<std::vector<A>>
- *    Accumulate the result of the parser until it fails, this parser never fails, since it can returns an empty vector
+ *    Accumulate the result of the parser until it fails, this parser only fails on a committed failure
+ *    An iteration that consumes nothing, like a lookahead, is the last one: it would succeed forever
  */
 template<typename T>
 Parser<std::vector<T>> many(Parser<T> const& p) {
-    return [=] (TokenStream& it) {
+    return [=] (TokenStream& it) -> Result<std::vector<T>> {
         std::vector<T> res;
         while(true) {
-            auto r = try_(p)(it);
+            auto before = it.position();
+            auto r = internal::attempt(p, it);
+            if (is_committed(r))
+                return std::get<ParserError>(r);
             if (has_failed(r))
                 return res;
             res.emplace_back(std::move(std::get<T>(r)));
+            if (it.position() == before)
+                return res;
         }
     };
 }
@@ -459,24 +310,34 @@ Parser<std::tuple<T, std::vector<T>>> some(Parser<T> const& p) {
 
 
 /*
- * join (Parser<std::variant<A...>>) -> Parser<B>
- *    Run the parser and convert the result into B, All types in the variant need to be convertible to B
- */
-template<typename T, typename...Ts>
-Parser<T> join (Parser<std::variant<T, Ts...>> const& parser) {
-    return map([] (auto r) -> T { return std::visit([] (auto a) { return std::move(a); }, std::move(r)); }, parser);
-}
-
-
-
-
-
-/*
- * log_begin (std::size_t, std::string)
- *    Print the begin message with spaces before, used by 'log'
+ * chainl1 (Parser<A>, Parser<O>, A(A, O, A)) -> Parser<A>
+ *    Parse 'A (O A)*' and fold it from the left while parsing: fold(fold(a1, o1, a2), o2, a3)...
+ *    An operator not followed by an operand is left in the stream, like 'many'
  */
-void log_begin(std::size_t spaces, std::string const& name) {
-    ws::module::noticeln(ws::module::spaces(spaces), "• Begin <", ws::module::style::bold, name, ws::module::style::reset, ">");
+template<typename T, typename O, typename F>
+Parser<T> chainl1(Parser<T> const& operand, Parser<O> const& op, F && fold) {
+    return [operand, op, fold] (TokenStream& it) -> Result<T> {
+        auto first = operand(it);
+        if (has_failed(first))
+            return first;
+
+        T lhs = std::move(std::get<T>(first));
+        while(true) {
+            auto backup = it;
+            auto o = op(backup);
+            if (is_committed(o))
+                return std::get<ParserError>(o);
+            if (has_failed(o))
+                return lhs;
+            auto rhs = operand(backup);
+            if (is_committed(rhs))
+                return std::get<ParserError>(rhs);
+            if (has_failed(rhs))
+                return lhs;
+            it = backup;
+            lhs = fold(std::move(lhs), std::move(std::get<O>(o)), std::move(std::get<T>(rhs)));
+        }
+    };
 }
 
 
@@ -484,27 +345,43 @@ void log_begin(std::size_t spaces, std::string const& name) {
 
 
 /*
- * log_success (std::size_t, std::string, T)
- *    Print the success message with spaces before, used by 'log'
+ * chainr1 (Parser<A>, Parser<O>, A(A, O, A)) -> Parser<A>
+ *    Parse 'A (O A)*' and fold it from the right: fold(a1, o1, fold(a2, o2, a3))...
+ *    The operands waiting for their right hand side are kept in a vector, allocated only if there is an operator
  */
-template<typename T>
-void log_success(std::size_t spaces, std::string const& name, T const& object) {
-    ws::module::successln(
-        ws::module::spaces(spaces), 
-        "• <", ws::module::style::bold, name, ws::module::style::reset, "> succeed: ", 
-        ws::module::colour::fg::cyan, object);
-}
-
-
-
-
+template<typename T, typename O, typename F>
+Parser<T> chainr1(Parser<T> const& operand, Parser<O> const& op, F && fold) {
+    return [operand, op, fold] (TokenStream& it) -> Result<T> {
+        auto first = operand(it);
+        if (has_failed(first))
+            return first;
+
+        T rhs = std::move(std::get<T>(first));
+        std::vector<std::tuple<T, O>> pending;
+        while(true) {
+            auto backup = it;
+            auto o = op(backup);
+            if (is_committed(o))
+                return std::get<ParserError>(o);
+            if (has_failed(o))
+                break;
+            auto next = operand(backup);
+            if (is_committed(next))
+                return std::get<ParserError>(next);
+            if (has_failed(next))
+                break;
+            it = backup;
+            pending.emplace_back(std::move(rhs), std::move(std::get<O>(o)));
+            rhs = std::move(std::get<T>(next));
+        }
 
-/*
- * log_failure (std::size_t, std::string, ParserError)
- *    Print the failure message with spaces before, used by 'log'
- */
-void log_failure(std::size_t spaces, std::string const& name, ParserError const& error) {
-    ws::module::warnln(ws::module::spaces(spaces), "• <", ws::module::style::bold, name, ws::module::style::reset, "> failed: ", error.what());
+        while(!pending.empty()) {
+            auto& [lhs, o] = pending.back();
+            rhs = fold(std::move(lhs), std::move(o), std::move(rhs));
+            pending.pop_back();
+        }
+        return rhs;
+    };
 }
 
 
@@ -512,11 +389,12 @@ void log_failure(std::size_t spaces, std::string const& name, ParserError const&
 
 
 /*
- * log_exception (std::size_t, std::string)
- *    Print the exception message with spaces before, used by 'log'
+ * join (Parser<std::variant<A...>>) -> Parser<B>
+ *    Run the parser and convert the result into B, All types in the variant need to be convertible to B
  */
-void log_exception(std::size_t spaces, std::string const& name) {
-    ws::module::warnln(ws::module::spaces(spaces), "• <", ws::module::style::bold, name, ws::module::style::reset, "> threw an exception");
+template<typename T, typename...Ts>
+Parser<T> join (Parser<std::variant<T, Ts...>> const& parser) {
+    return map([] (auto r) -> T { return std::visit([] (auto a) { return std::move(a); }, std::move(r)); }, parser);
 }
 
 
@@ -525,25 +403,14 @@ void log_exception(std::size_t spaces, std::string const& name) {
 
 /*
  * log (std::string, Parser<A>) -> Parser<A>
- *    Print a message when the parser is run, and when it succeed/fail, returns the result of that parser, the type A need to implement operator<<(std::ostream&)
+ *    Send an event to the TraceSink of the ParserContext when the parser is run, and when it succeed/fail, returns the result of that parser
+ *    The type A need to implement operator<<(std::ostream&), the value is only printed if the sink prints it
+ *    Nothing is traced without a sink, and the tracing is compiled out when WS_PARSER_TRACE is 0
  */
 template<typename T>
 Parser<T> log(std::string const& name, Parser<T> const& parser) {
     return [=] (TokenStream& it) {
-        log_begin(0, name);
-        try {
-            auto res = parser(it);
-
-            if (has_failed(res))
-                log_failure(0, name, std::get<ParserError>(res));
-            else
-                log_success(0, name, std::get<T>(res));
-
-            return std::move(res);
-        } catch(...) {
-            log_exception(0, name);
-            throw;
-        }
+        return internal::traced<T>(name, it, parser);
     };
 }
 
@@ -553,28 +420,17 @@ Parser<T> log(std::string const& name, Parser<T> const& parser) {
 
 /*
  * log (std::size_t&, std::string, Parser<A>) -> Parser<A>
- *    Equivalent of log but will use spaces to indent the code, it also increment it for the future logs
+ *    Equivalent of log but the depth of the events is counted in 'depth' instead of the ParserContext
  */
 template<typename T>
-Parser<T> log(std::size_t& spaces, std::string const& name, Parser<T> const& parser) {
-    return [&spaces, name, parser] (TokenStream& it) {
-        log_begin(spaces, name);
-        try {
-            spaces += 2;
-            auto res = parser(it);
-            spaces -= 2;
-
-            if (has_failed(res))
-                log_failure(spaces, name, std::get<ParserError>(res));
-            else
-                log_success(spaces, name, std::get<T>(res));
-
-            return std::move(res);
-        } catch(...) {
-            spaces -= 2;
-            log_exception(spaces, name);
-            throw;
+Parser<T> log(std::size_t& depth, std::string const& name, Parser<T> const& parser) {
+    return [&depth, name, parser] (TokenStream& it) -> Result<T> {
+        if constexpr (trace_compiled) {
+            auto* context = it.context();
+            if (context != nullptr && context->trace_sink() != nullptr)
+                return internal::trace<T>(*context->trace_sink(), depth, name, it, parser);
         }
+        return parser(it);
     };
 }
 
@@ -584,12 +440,14 @@ Parser<T> log(std::size_t& spaces, std::string const& name, Parser<T> const& par
 
 /*
  * optional (Parser<A>) -> Parser<std::optional<A>>
- *    Run the parser, if it fails return an empty optional, can't fail
+ *    Run the parser, if it fails return an empty optional, only fails on a committed failure
  */
 template<typename T>
 Parser<std::optional<T>> optional(Parser<T> const& p) {
     return [=] (TokenStream& it) -> Result<std::optional<T>> {
-        auto res = try_(p)(it);
+        auto res = internal::attempt(p, it);
+        if (is_committed(res))
+            return std::get<ParserError>(res);
         if (has_failed(res))
             return std::nullopt;
         return std::optional<T>(std::move(std::get<T>(res)));
@@ -601,16 +459,17 @@ Parser<std::optional<T>> optional(Parser<T> const& p) {
 
 
 /*
- * ref (Parser<A>) -> Parser<A>
- *    By default parser are copied, but when you need recursion, you have to declare the parser first then referenced it with ref(parser)
- *    Example:
- *        Parser<Thing> parenthesis_expr;
- *        parenthesis_expr = left_par & ref(parenthesis_expr) & right_par | expr;
+ * commit (Parser<A>) -> Parser<A>
+ *    Cut: run the parser, if it fails the error is committed and nothing backtracks over it anymore, the whole parse fails
+ *    Use it once the tokens already consumed leave no other choice, like after a '('
  */
 template<typename T>
-Parser<T> ref(Parser<T> const& p) {
-    return [&p] (TokenStream& it) {
-        return std::move(p(it));
+Parser<T> commit(Parser<T> const& p) {
+    return [=] (TokenStream& it) -> Result<T> {
+        auto res = p(it);
+        if (has_failed(res))
+            return std::get<ParserError>(res).committed();
+        return res;
     };
 }
 
@@ -619,12 +478,21 @@ Parser<T> ref(Parser<T> const& p) {
 
 
 /*
- * operator ~ (Parser<A>) -> Parser<A>
- *    Equivalent of 'ref'
+ * peek (Parser<A>) -> Parser<std::monostate>
+ *    Run the parser on a copy of the stream, succeed if it succeeds, nothing is consumed and its result is dropped
+ *    Only the error of a failed peek is a failure of the parse, not every token the parser tried
  */
 template<typename T>
-Parser<T> operator~(Parser<T> const& p) {
-    return ref(p);
+Parser<std::monostate> peek(Parser<T> const& p) {
+    return [=] (TokenStream& it) -> Result<std::monostate> {
+        auto res = internal::probe(p, it);
+        if (!has_failed(res))
+            return std::monostate();
+        auto const& error = std::get<ParserError>(res);
+        if (auto* context = it.context(); context && error.kind() == ParserError::Kind::Expected)
+            context->expect(error.expected_tokens(), error.position());
+        return error;
+    };
 }
 
 
@@ -632,26 +500,34 @@ Parser<T> operator~(Parser<T> const& p) {
 
 
 /*
- * operator > (Parser<A>, Parser<B>) -> Parser<B>
- *    Equivalent of 'a & b' but discard the first result
+ * not_ (Parser<A>) -> Parser<std::monostate>
+ *    Run the parser on a copy of the stream, succeed if it fails, nothing is consumed
  */
-template<typename A, typename B>
-Parser<B> operator > (Parser<A> const& pa, Parser<B> const& pb) {
-    return mapI([] (auto, auto res) { return res; }, pa & pb);
+template<typename T>
+Parser<std::monostate> not_(Parser<T> const& p) {
+    return [=] (TokenStream& it) -> Result<std::monostate> {
+        if (has_failed(internal::probe(p, it)))
+            return std::monostate();
+        return ParserError::error(it.position());
+    };
 }
 
 
 
 
 
-
 /*
- * operator < (Parser<A>, Parser<B>) -> Parser<A>
- *    Equivalent of 'a & b' but discard the second result
+ * lookahead (std::size_t, TokenSet) -> Parser<std::monostate>
+ *    Succeed if the n-th next token is one of the set, lookahead(1, ...) tests the next token, nothing is consumed nor copied
+ *    n starts at 1, there is no token before the next one
  */
-template<typename A, typename B>
-Parser<A> operator < (Parser<A> const& pa, Parser<B> const& pb) {
-    return mapI([] (auto res, auto) { return res; }, pa & pb);
+inline Parser<std::monostate> lookahead(std::size_t n, TokenSet kinds) {
+    assert(n > 0 && "lookahead: the next token is the first one, n starts at 1");
+    return [=] (TokenStream& it) -> Result<std::monostate> {
+        if (kinds.intersects(it.peek(n - 1)))
+            return std::monostate();
+        return internal::fail(it, kinds, n - 1);
+    };
 }
 
 
@@ -659,69 +535,73 @@ Parser<A> operator < (Parser<A> const& pa, Parser<B> const& pb) {
 
 
 /*
- * operator<< for
- *    std::tuple
- *    std::optional
- *    std::unique_ptr
- *    std::variant
- *    std::vector
+ * ref (Parser<A>) -> Parser<A>
+ *    By default parser are copied, but when you need recursion, you have to declare the parser first then referenced it with ref(parser)
+ *    Example:
+ *        Parser<Thing> parenthesis_expr;
+ *        parenthesis_expr = left_par & ref(parenthesis_expr) & right_par | expr;
  */
-
-
-
-
-
-template<typename...Ts>
-std::ostream& operator<<(std::ostream& os, std::tuple<Ts...> const& tuple) {
-    os << "<";
-    return internal::print_tuple(os, tuple, std::make_index_sequence<sizeof...(Ts)>()) << ">";
+template<typename T>
+Parser<T> ref(Parser<T> const& p) {
+    return [&p] (TokenStream& it) {
+        return std::move(p(it));
+    };
 }
 
 
 
 
 
+/*
+ * memo (Parser<A>) -> Parser<A>
+ *    Packrat memoization, when the ParserContext of the stream enables it, the parser is run at most once per token and the result is reused
+ *    A must be copyable, or a std::unique_ptr to a type with a 'clone' method
+ */
 template<typename T>
-std::ostream& operator<<(std::ostream& os, std::vector<T> const& vector) {
-    bool first = true;
-    os << "[";
-    for(auto const& t : vector) {
-        if (!first)
-            os << ", ";
-        os << t;
-        first = false;
-    }
-    return os << "]";
+Parser<T> memo(Parser<T> const& p) {
+    return [p, id = internal::next_memo_id()] (TokenStream& it) {
+        return internal::memoize<T>(id, it, p);
+    };
 }
 
 
 
 
 
+/*
+ * operator ~ (Parser<A>) -> Parser<A>
+ *    Equivalent of 'ref'
+ */
 template<typename T>
-std::ostream& operator<<(std::ostream& os, std::unique_ptr<T> const& ptr) {
-    return os << "*" << *ptr;
+Parser<T> operator~(Parser<T> const& p) {
+    return ref(p);
 }
 
 
 
 
 
-template<typename T>
-std::ostream& operator<<(std::ostream& os, std::optional<T> const& opt) {
-    if (opt)
-        return os << "$" << *opt;
-    return os << "$null";
+/*
+ * operator > (Parser<A>, Parser<B>) -> Parser<B>
+ *    Equivalent of 'a & b' but discard the first result
+ */
+template<typename A, typename B>
+Parser<B> operator > (Parser<A> const& pa, Parser<B> const& pb) {
+    return mapI([] (auto, auto res) { return res; }, pa & pb);
 }
 
 
 
 
 
-template<typename...Ts>
-std::ostream& operator<<(std::ostream& os, std::variant<Ts...> const& variant) {
-    os << "|" << variant.index() << ": ";
-    return std::visit([&os] (auto const& v) -> std::ostream& { return os << v; }, variant) << "|";
+
+/*
+ * operator < (Parser<A>, Parser<B>) -> Parser<A>
+ *    Equivalent of 'a & b' but discard the second result
+ */
+template<typename A, typename B>
+Parser<A> operator < (Parser<A> const& pa, Parser<B> const& pb) {
+    return mapI([] (auto res, auto) { return res; }, pa & pb);
 }
 
 
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <json.hpp>
+#include <ws/parser/ParserTrace.hpp>
+
+namespace ws::parser {
+
+/*
+ * RuleProfile
+ *    Counters of every rule named 'name' by 'log', over all the parses recorded by a ProfileSink
+ *    tokens: tokens consumed by the successful invocations
+ *    backtracks: failed invocations that had consumed tokens, which the caller then rolls back
+ *    cumulative: time spent in the rule and its children, counted once for a recursive rule
+ *    self: time spent in the rule minus the time of the traced rules it ran
+ */
+struct RuleProfile {
+    std::string name;
+    std::size_t invocations = 0;
+    std::size_t successes = 0;
+    std::size_t failures = 0;
+    std::size_t tokens = 0;
+    std::size_t backtracks = 0;
+    std::chrono::nanoseconds cumulative{0};
+    std::chrono::nanoseconds self{0};
+};
+
+/*
+ * ProfileSink
+ *    TraceSink counting the invocations, results and time of each rule named by 'log', set it on a ParserContext
+ *    It is a trace sink, so the profiler costs nothing if it isn't set, and is compiled out with WS_PARSER_TRACE=0
+ *    The copies of a rule share the same name, and therefore the same counters
+ *    The names are cached by address, clear the sink before profiling another grammar
+ */
+class ProfileSink : public TraceSink {
+public:
+    using clock = std::chrono::steady_clock;
+
+    void record(TraceEvent const& event, TraceValue const& value) override;
+
+    // Sorted by self time, the most expensive first
+    std::vector<RuleProfile> rules() const;
+    void clear();
+
+    void print_table(std::ostream& os) const;
+    nlohmann::json to_json() const;
+
+private:
+
+    struct Frame {
+        std::size_t rule;
+        std::size_t position;
+        clock::time_point begin;
+        std::chrono::nanoseconds children{0};
+    };
+
+    std::size_t rule_of(std::string const* name);
+
+    std::vector<RuleProfile> profiles;
+    std::vector<std::size_t> active;
+    std::unordered_map<std::string const*, std::size_t> by_address;
+    std::unordered_map<std::string, std::size_t> by_name;
+    std::vector<Frame> frames;
+};
+
+}
@@ -1,32 +1,77 @@
 #pragma once
 
-#include <vector>
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <variant>
 #include <optional>
 #include <memory>
+#include <type_traits>
 
 #include <ws/parser/ast/AST.hpp>
+#include <ws/parser/token/TokenSet.hpp>
+#include <ws/parser/token/TokenBuffer.hpp>
 
 namespace ws::parser {
 
+/*
+ * ParserError
+ *    Failing is the normal path of a backtracking parser, so the error is a small trivially copyable value:
+ *    a kind, the index of the token where it happened, and the set of expected tokens
+ *    The line and the column are only known by the final error, see 'at'
+ *    The message is only formatted by what()
+ */
 class ParserError {
 public:
 
-    static ParserError expected(std::vector<std::string> const& tokens);
-    static ParserError unknown_token(std::string const& token);
-    static ParserError error();
+    enum class Kind : std::uint8_t {
+        Unknown,
+        Expected,
+        UnknownToken,
+        TooDeep
+
+    };
+
+    static constexpr std::size_t unknown_position = static_cast<std::size_t>(-1);
+
+    static ParserError expected(TokenSet tokens, std::size_t position);
+    static ParserError unknown_token(std::size_t position);
+    static ParserError too_deep(std::size_t position);
+    static ParserError error(std::size_t position = unknown_position);
+
+    Kind kind() const;
+    std::size_t position() const;
+    TokenSet expected_tokens() const;
+
+    // Copy of the error located in the source, the line and the column start at 1
+    ParserError at(std::size_t line, std::size_t column) const;
+    std::size_t line() const;
+    std::size_t column() const;
+
+    // Copy of the error that forbids any backtracking, see 'commit'
+    ParserError committed() const;
+    bool is_committed() const;
 
     std::string what() const;
 
 private:
 
-    ParserError(std::string const& error_msg);
+    ParserError(Kind kind, TokenSet expected, std::size_t position);
 
-    std::string error_msg;
+    Kind error_kind;
+    TokenSet expected_set;
+    std::size_t error_position;
+    std::size_t error_line = 0;
+    std::size_t error_column = 0;
+    bool cut = false;
 
 };
 
+static_assert(std::is_trivially_copyable_v<ParserError>, "ParserError must stay cheap to copy");
+
+// Line and column of the error in the tokens [begin, end), just after the last token at the end of the stream
+ParserError locate(ParserError const& error, TokenView const& tokens, std::size_t begin, std::size_t end);
+
 using AST_ptr = std::unique_ptr<AST>;
 using ParserResult = std::variant<AST_ptr, ParserError>;
 
@@ -0,0 +1,1165 @@
+#pragma once
+
+#include <type_traits>
+
+#include <ws/parser/AnyParser.hpp>
+#include <ws/parser/ParserCommon.hpp>
+#include <ws/parser/token/TokenSet.hpp>
+
+namespace ws::parser::ct {
+
+/* Compile-time Parser Combinator:
+ * -> Same combinators as ParserInternal.hpp, but every parser is its own type instead of a std::function
+
+ *    A parser is any type deriving from ParserTag with:
+ *        using value_type = T;
+ *        Result<T> operator()(TokenStream&) const;
+ *        TokenSet first() const;      the tokens it can start with
+ *        bool nullable() const;       if it can succeed without consuming anything
+ *    ParserTag defines first/nullable as 'any token' and 'nullable', which is always correct, but never predictive
+
+ *    So 'eat(...) & eat(...) | ...' is a single nested type, that the compiler can inline entirely
+ *    The only type erasure is Rule<A>, used where the grammar is recursive, it stores its parser inline without allocation
+
+ *    The FIRST sets are computed once when the grammar is built,
+ *    operator |, many and optional use them to run only the alternatives that can start with the next token
+
+ * Parser:
+
+ * eat (TokenType, TokenSubType) -> Eat
+ *    Consume the next token of the stream if the type/subtype match, or returns an error, a failed eat leaves the stream where it was
+ *    The token is returned as a TokenRef into the input, it is never copied
+ *    The end of the stream is a normal failure, no exception is thrown
+
+ * one_of (TokenSet) -> OneOf
+ *    Equivalent of 'join(eat(...) | eat(...) | ...)' in a single mask test, returns the matched token
+
+ * operator & (A, B) -> Sequence<A, B>
+ *    Run sequencially both parser, returns their result in a tuple, or an error, nested tuples are flatten
+
+ * operator | (A, B) -> Alternative<A, B>
+ *    Run the first parser, if it fails rollback and run the second parser, if it fails returns an error, nested variants are flatten
+ *    If the next token can only start one of them, only this one is run, a failure still rollbacks the stream
+ *    A committed failure of the first parser is returned without running the second one
+
+ * many (A) -> Many<A>
+ *    Accumulate the result of the parser until it fails, this parser only fails on a committed failure
+ *    An iteration that consumes nothing, like a lookahead, is the last one: it would succeed forever
+
+ * some (A) -> Sequence<A, Many<A>>
+ *    Combination of itself and many, will parse A at least once, if the first iteration fails, an error is resturned
+
+ * chainl1 (A, O, A(A, O, A)) -> Chain<A, O, F, Associativity::Left>
+ *    Parse 'A (O A)*' and fold it from the left while parsing: fold(fold(a1, o1, a2), o2, a3)...
+
+ * chainr1 (A, O, A(A, O, A)) -> Chain<A, O, F, Associativity::Right>
+ *    Parse 'A (O A)*' and fold it from the right: fold(a1, o1, fold(a2, o2, a3))...
+
+ * operator < (A, B) -> Left<A, B>
+ *    Equivalent of 'a & b' but discard the second result
+
+ * operator > (A, B) -> Right<A, B>
+ *    Equivalent of 'a & b' but discard the first result
+
+ * optional (A) -> Optional<A>
+ *    Run the parser, if it fails return an empty optional, only fails on a committed failure
+
+ * commit (A) -> Commit<A>
+ *    Cut: run the parser, if it fails the error is committed and nothing backtracks over it anymore, the whole parse fails
+ *    Use it once the tokens already consumed leave no other choice, like after a '('
+
+ * nested (std::size_t, A) -> Nested<A>
+ *    Count a level of nesting in the ParserContext while the parser runs, past 'max_depth' levels it fails with a committed TooDeep error
+ *    Wrap the recursive alternatives of a grammar with it, so a deep input cannot overflow the thread stack
+
+ * peek (A) -> Peek<A>
+ *    Succeed if the parser succeeds, nothing is consumed and no result is built
+ *    When A is eat or one_of only the kind of the next token is tested, any other parser is run on a copy of the stream
+
+ * not_ (A) -> Not<A>
+ *    Succeed if the parser fails, nothing is consumed, same fast path as peek
+
+ * lookahead (std::size_t, TokenSet) -> Lookahead
+ *    Succeed if the n-th next token is one of the set, lookahead(1, ...) tests the next token, nothing is consumed nor copied
+
+ * Rule<A>
+ *    Type erased parser of A, declare it first, reference it with ref or ~, and assign it later
+ *    The parsers built with a reference to a rule before its assignment see a conservative FIRST set
+ *    Example:
+ *        Rule<Thing> parenthesis_expr;
+ *        parenthesis_expr = left_par & ~parenthesis_expr & right_par | expr;
+
+ * ref (Rule<A>) -> Ref<A>
+ *    Reference a rule without copying it, needed for recursion
+
+ * operator ~ (Rule<A>) -> Ref<A>
+ *    Equivalent of 'ref'
+
+ * map (B(A), A) -> Map<F, A>
+ *    Run the callback on the result of the parser if it has succeeded
+
+ * mapI (B(A...), std::tuple<A...>) -> MapI<F, A>
+ *    Equivalent of 'map' but unpack each element of a tuple
+
+ * join (std::variant<A...>) -> Join<B, P>
+ *    Run the parser and convert the result into B, the first type of the variant, All types in the variant need to be convertible to B
+
+ * memo (A) -> Memo<A>
+ *    Packrat memoization, when the ParserContext of the stream enables it, the parser is run at most once per token and the result is reused
+
+ * log (std::string, A) -> Log<A>
+ *    Trace when the parser is run, and when it succeed/fail, to the TraceSink of the ParserContext, returns the result of that parser
+ *    Compiled out when WS_PARSER_TRACE is 0
+
+ */
+
+
+
+
+
+/*
+ * Internal Helpers
+ */
+
+namespace detail {
+
+
+
+
+
+// Every parser derive from ParserTag, it is used to restrict the operators to the parsers
+// It also gives the conservative FIRST set of a parser: it can start with anything, even nothing
+
+struct ParserTag {
+    TokenSet first() const {
+        return TokenSet::all();
+    }
+
+    bool nullable() const {
+        return true;
+    }
+};
+
+template<typename P>
+constexpr auto is_parser_v = std::is_base_of_v<ParserTag, std::decay_t<P>>;
+
+template<typename...Ps>
+using enable_if_parsers = std::enable_if_t<(is_parser_v<Ps> && ...), int>;
+
+template<typename P>
+using value_t = typename std::decay_t<P>::value_type;
+
+
+
+
+
+// Run the parser, if it fails rollback the stream where it was, see ParserCommon.hpp
+
+using ws::parser::internal::attempt;
+
+
+
+
+
+// Tokens that can be next when the parser succeed, any token if the parser can succeed without consuming
+
+template<typename P>
+TokenSet viable(P const& p) {
+    return p.nullable() ? TokenSet::all() : p.first();
+}
+
+
+
+
+
+}
+
+using detail::ParserTag;
+
+
+
+
+
+/*
+ * eat (TokenKind) -> Eat
+ * eat (TokenType, TokenSubType) -> Eat
+ *    Consume the next token of the stream if the kind match, or returns an error, a failed eat leaves the stream where it was
+ */
+struct Eat : ParserTag {
+    using value_type = TokenRef;
+
+    explicit Eat(TokenKind kind) : kind(kind) {}
+
+    Result<TokenRef> operator()(TokenStream& it) const {
+        if (TokenSet::of(kind).intersects(it.peek())) {
+            auto t = it.token();
+            ++it;
+            return t;
+        }
+        return ws::parser::internal::fail(it, TokenSet::of(kind));
+    }
+
+    TokenSet first() const {
+        return TokenSet::of(kind);
+    }
+
+    bool nullable() const {
+        return false;
+    }
+
+    TokenKind kind;
+};
+
+inline Eat eat(TokenKind kind) {
+    return Eat(kind);
+}
+
+inline Eat eat(TokenType type, TokenSubType subtype) {
+    return Eat(kind_of(type, subtype));
+}
+
+
+
+
+
+/*
+ * one_of (TokenSet) -> OneOf
+ *    Equivalent of 'join(eat(...) | eat(...) | ...)' in a single mask test, returns the matched token
+ */
+struct OneOf : ParserTag {
+    using value_type = TokenRef;
+
+    explicit OneOf(TokenSet kinds) : kinds(kinds) {}
+
+    Result<TokenRef> operator()(TokenStream& it) const {
+        if (kinds.intersects(it.peek())) {
+            auto t = it.token();
+            ++it;
+            return t;
+        }
+        return ws::parser::internal::fail(it, kinds);
+    }
+
+    TokenSet first() const {
+        return kinds;
+    }
+
+    bool nullable() const {
+        return false;
+    }
+
+    TokenSet kinds;
+};
+
+inline OneOf one_of(TokenSet kinds) {
+    return OneOf(kinds);
+}
+
+
+
+
+
+/*
+ * operator & (A, B) -> Sequence<A, B>
+ *    Run sequencially both parser, returns their result in a tuple, or an error, nested tuples are flatten
+ */
+template<typename A, typename B>
+struct Sequence : ParserTag {
+    using value_type = ws::parser::internal::Combine_t<detail::value_t<A>, detail::value_t<B>>;
+
+    Sequence(A a, B b) : a(std::move(a)), b(std::move(b)) {}
+
+    Result<value_type> operator()(TokenStream& it) const {
+        auto ra = a(it);
+        if (has_failed(ra))
+            return std::get<ParserError>(ra);
+
+        auto rb = b(it);
+        if (has_failed(rb))
+            return std::get<ParserError>(rb);
+
+        return ws::parser::internal::Combine<detail::value_t<A>, detail::value_t<B>>::combine(std::move(std::get<1>(ra)), std::move(std::get<1>(rb)));
+    }
+
+    TokenSet first() const {
+        return a.nullable() ? a.first() | b.first() : a.first();
+    }
+
+    bool nullable() const {
+        return a.nullable() && b.nullable();
+    }
+
+    A a;
+    B b;
+};
+
+template<typename A, typename B, detail::enable_if_parsers<A, B> = 0>
+Sequence<A, B> operator & (A a, B b) {
+    return Sequence<A, B>(std::move(a), std::move(b));
+}
+
+
+
+
+
+/*
+ * operator | (A, B) -> Alternative<A, B>
+ *    Run the first parser, if it fails rollback and run the second parser, if it fails returns an error, nested variants are flatten
+ *    If the next token can only start one of them, only this one is run, a failure still rollbacks the stream
+ */
+template<typename A, typename B>
+struct Alternative : ParserTag {
+    using value_type = ws::parser::internal::Either_t<detail::value_t<A>, detail::value_t<B>>;
+
+    Alternative(A a, B b) : a(std::move(a)), b(std::move(b)), viable_a(detail::viable(this->a)), viable_b(detail::viable(this->b)) {}
+
+    Result<value_type> operator()(TokenStream& it) const {
+        using Either = ws::parser::internal::Either<detail::value_t<A>, detail::value_t<B>>;
+
+        auto next = it.peek();
+        bool maybe_a = viable_a.intersects(next);
+        bool maybe_b = viable_b.intersects(next);
+
+        // Only one alternative can start here, the other one is not tried
+        if (maybe_a != maybe_b) {
+            if (maybe_a) {
+                auto ra = detail::attempt(a, it);
+                if (has_failed(ra))
+                    return std::get<ParserError>(ra);
+                return Either::left(std::move(std::get<1>(ra)));
+            }
+
+            auto rb = detail::attempt(b, it);
+            if (has_failed(rb))
+                return std::get<ParserError>(rb);
+            return Either::right(std::move(std::get<1>(rb)));
+        }
+
+        if (!maybe_a)
+            return ws::parser::internal::fail(it, first());
+
+        auto ra = detail::attempt(a, it);
+        if (!has_failed(ra))
+            return Either::left(std::move(std::get<1>(ra)));
+        if (is_committed(ra))
+            return std::get<ParserError>(ra);
+
+        auto rb = detail::attempt(b, it);
+        if (!has_failed(rb))
+            return Either::right(std::move(std::get<1>(rb)));
+
+        return std::get<ParserError>(rb);
+    }
+
+    TokenSet first() const {
+        return a.first() | b.first();
+    }
+
+    bool nullable() const {
+        return a.nullable() || b.nullable();
+    }
+
+    A a;
+    B b;
+    TokenSet viable_a;
+    TokenSet viable_b;
+};
+
+template<typename A, typename B, detail::enable_if_parsers<A, B> = 0>
+Alternative<A, B> operator | (A a, B b) {
+    return Alternative<A, B>(std::move(a), std::move(b));
+}
+
+
+
+
+
+/*
+ * operator < (A, B) -> Left<A, B>
+ *    Equivalent of 'a & b' but discard the second result
+ */
+template<typename A, typename B>
+struct Left : ParserTag {
+    using value_type = detail::value_t<A>;
+
+    Left(A a, B b) : a(std::move(a)), b(std::move(b)) {}
+
+    Result<value_type> operator()(TokenStream& it) const {
+        auto ra = a(it);
+        if (has_failed(ra))
+            return ra;
+
+        auto rb = b(it);
+        if (has_failed(rb))
+            return std::get<ParserError>(rb);
+
+        return ra;
+    }
+
+    TokenSet first() const {
+        return a.nullable() ? a.first() | b.first() : a.first();
+    }
+
+    bool nullable() const {
+        return a.nullable() && b.nullable();
+    }
+
+    A a;
+    B b;
+};
+
+template<typename A, typename B, detail::enable_if_parsers<A, B> = 0>
+Left<A, B> operator < (A a, B b) {
+    return Left<A, B>(std::move(a), std::move(b));
+}
+
+
+
+
+
+/*
+ * operator > (A, B) -> Right<A, B>
+ *    Equivalent of 'a & b' but discard the first result
+ */
+template<typename A, typename B>
+struct Right : ParserTag {
+    using value_type = detail::value_t<B>;
+
+    Right(A a, B b) : a(std::move(a)), b(std::move(b)) {}
+
+    Result<value_type> operator()(TokenStream& it) const {
+        auto ra = a(it);
+        if (has_failed(ra))
+            return std::get<ParserError>(ra);
+
+        return b(it);
+    }
+
+    TokenSet first() const {
+        return a.nullable() ? a.first() | b.first() : a.first();
+    }
+
+    bool nullable() const {
+        return a.nullable() && b.nullable();
+    }
+
+    A a;
+    B b;
+};
+
+template<typename A, typename B, detail::enable_if_parsers<A, B> = 0>
+Right<A, B> operator > (A a, B b) {
+    return Right<A, B>(std::move(a), std::move(b));
+}
+
+
+
+
+
+/*
+ * map (B(A), A) -> Map<F, A>
+ *    Run the callback on the result of the parser if it has succeeded
+ */
+template<typename F, typename P>
+struct Map : ParserTag {
+    using value_type = std::invoke_result_t<F const&, detail::value_t<P>>;
+
+    Map(F f, P p) : f(std::move(f)), p(std::move(p)) {}
+
+    Result<value_type> operator()(TokenStream& it) const {
+        auto r = p(it);
+        if (has_failed(r))
+            return std::get<ParserError>(r);
+        return f(std::move(std::get<1>(r)));
+    }
+
+    TokenSet first() const {
+        return p.first();
+    }
+
+    bool nullable() const {
+        return p.nullable();
+    }
+
+    F f;
+    P p;
+};
+
+template<typename F, typename P, detail::enable_if_parsers<P> = 0>
+Map<std::decay_t<F>, P> map(F&& f, P p) {
+    return Map<std::decay_t<F>, P>(std::forward<F>(f), std::move(p));
+}
+
+
+
+
+
+/*
+ * mapI (B(A...), std::tuple<A...>) -> MapI<F, A>
+ *    Equivalent of 'map' but unpack each element of a tuple
+ */
+template<typename F, typename P, typename = detail::value_t<P>>
+struct MapI;
+
+template<typename F, typename P, typename...Ts>
+struct MapI<F, P, std::tuple<Ts...>> : ParserTag {
+    using value_type = std::invoke_result_t<F const&, Ts...>;
+
+    MapI(F f, P p) : f(std::move(f)), p(std::move(p)) {}
+
+    Result<value_type> operator()(TokenStream& it) const {
+        auto r = p(it);
+        if (has_failed(r))
+            return std::get<ParserError>(r);
+        return ws::parser::internal::apply_tuple(f, std::move(std::get<1>(r)), std::make_index_sequence<sizeof...(Ts)>());
+    }
+
+    TokenSet first() const {
+        return p.first();
+    }
+
+    bool nullable() const {
+        return p.nullable();
+    }
+
+    F f;
+    P p;
+};
+
+template<typename F, typename P, detail::enable_if_parsers<P> = 0>
+MapI<std::decay_t<F>, P> mapI(F&& f, P p) {
+    return MapI<std::decay_t<F>, P>(std::forward<F>(f), std::move(p));
+}
+
+
+
+
+
+/*
+ * many (A) -> Many<A>
+ *    Accumulate the result of the parser until it fails, this parser only fails on a committed failure
+ *    An iteration that consumes nothing, like a lookahead, is the last one: it would succeed forever
+ */
+template<typename P>
+struct Many : ParserTag {
+    using value_type = std::vector<detail::value_t<P>>;
+
+    explicit Many(P p) : p(std::move(p)), viable(detail::viable(this->p)) {}
+
+    Result<value_type> operator()(TokenStream& it) const {
+        value_type res;
+        while(viable.intersects(it.peek())) {
+            auto before = it.position();
+            auto r = detail::attempt(p, it);
+            if (is_committed(r))
+                return std::get<ParserError>(r);
+            if (has_failed(r))
+                return res;
+            res.emplace_back(std::move(std::get<1>(r)));
+            if (it.position() == before)
+                return res;
+        }
+        ws::parser::internal::expect(it, viable);
+        return res;
+    }
+
+    TokenSet first() const {
+        return p.first();
+    }
+
+    bool nullable() const {
+        return true;
+    }
+
+    P p;
+    TokenSet viable;
+};
+
+template<typename P, detail::enable_if_parsers<P> = 0>
+Many<P> many(P p) {
+    return Many<P>(std::move(p));
+}
+
+
+
+
+
+/*
+ * some (A) -> Sequence<A, Many<A>>
+ *    Combination of itself and many, will parse A at least once, if the first iteration fails, an error is resturned
+ */
+template<typename P, detail::enable_if_parsers<P> = 0>
+Sequence<P, Many<P>> some(P p) {
+    return p & many(p);
+}
+
+
+
+
+
+/*
+ * chainl1 (A, O, A(A, O, A)) -> Chain<A, O, F, Associativity::Left>
+ *    Parse 'A (O A)*' and fold it from the left while parsing: fold(fold(a1, o1, a2), o2, a3)...
+ *    An operator not followed by an operand is left in the stream, like 'many'
+
+ * chainr1 (A, O, A(A, O, A)) -> Chain<A, O, F, Associativity::Right>
+ *    Parse 'A (O A)*' and fold it from the right: fold(a1, o1, fold(a2, o2, a3))...
+ *    The operands waiting for their right hand side are kept in a vector, allocated only if there is an operator
+ */
+enum class Associativity {
+    Left, Right
+};
+
+template<typename P, typename O, typename F, Associativity Assoc>
+struct Chain : ParserTag {
+    using value_type = detail::value_t<P>;
+
+    Chain(P operand, O op, F fold) : operand(std::move(operand)), op(std::move(op)), fold(std::move(fold)), viable_op(detail::viable(this->op)) {}
+
+    Result<value_type> operator()(TokenStream& it) const {
+        auto first = operand(it);
+        if (has_failed(first))
+            return first;
+
+        value_type value = std::move(std::get<1>(first));
+        std::vector<std::tuple<value_type, detail::value_t<O>>> pending;
+
+        while(viable_op.intersects(it.peek())) {
+            auto backup = it;
+            auto o = op(backup);
+            if (is_committed(o))
+                return std::get<ParserError>(o);
+            if (has_failed(o))
+                break;
+            auto rhs = operand(backup);
+            if (is_committed(rhs))
+                return std::get<ParserError>(rhs);
+            if (has_failed(rhs))
+                break;
+            it = backup;
+
+            if constexpr (Assoc == Associativity::Left) {
+                value = fold(std::move(value), std::move(std::get<1>(o)), std::move(std::get<1>(rhs)));
+            } else {
+                pending.emplace_back(std::move(value), std::move(std::get<1>(o)));
+                value = std::move(std::get<1>(rhs));
+            }
+        }
+        if (!viable_op.intersects(it.peek()))
+            ws::parser::internal::expect(it, viable_op);
+
+        while(!pending.empty()) {
+            auto& [lhs, o] = pending.back();
+            value = fold(std::move(lhs), std::move(o), std::move(value));
+            pending.pop_back();
+        }
+        return value;
+    }
+
+    TokenSet first() const {
+        return operand.first();
+    }
+
+    bool nullable() const {
+        return operand.nullable();
+    }
+
+    P operand;
+    O op;
+    F fold;
+    TokenSet viable_op;
+};
+
+template<typename P, typename O, typename F, detail::enable_if_parsers<P, O> = 0>
+Chain<P, O, std::decay_t<F>, Associativity::Left> chainl1(P operand, O op, F&& fold) {
+    return Chain<P, O, std::decay_t<F>, Associativity::Left>(std::move(operand), std::move(op), std::forward<F>(fold));
+}
+
+template<typename P, typename O, typename F, detail::enable_if_parsers<P, O> = 0>
+Chain<P, O, std::decay_t<F>, Associativity::Right> chainr1(P operand, O op, F&& fold) {
+    return Chain<P, O, std::decay_t<F>, Associativity::Right>(std::move(operand), std::move(op), std::forward<F>(fold));
+}
+
+
+
+
+
+/*
+ * optional (A) -> Optional<A>
+ *    Run the parser, if it fails return an empty optional, only fails on a committed failure
+ */
+template<typename P>
+struct Optional : ParserTag {
+    using value_type = std::optional<detail::value_t<P>>;
+
+    explicit Optional(P p) : p(std::move(p)), viable(detail::viable(this->p)) {}
+
+    Result<value_type> operator()(TokenStream& it) const {
+        if (!viable.intersects(it.peek())) {
+            ws::parser::internal::expect(it, viable);
+            return value_type(std::nullopt);
+        }
+
+        auto r = detail::attempt(p, it);
+        if (is_committed(r))
+            return std::get<ParserError>(r);
+        if (has_failed(r))
+            return value_type(std::nullopt);
+        return value_type(std::move(std::get<1>(r)));
+    }
+
+    TokenSet first() const {
+        return p.first();
+    }
+
+    bool nullable() const {
+        return true;
+    }
+
+    P p;
+    TokenSet viable;
+};
+
+template<typename P, detail::enable_if_parsers<P> = 0>
+Optional<P> optional(P p) {
+    return Optional<P>(std::move(p));
+}
+
+
+
+
+
+/*
+ * commit (A) -> Commit<A>
+ *    Cut: run the parser, if it fails the error is committed and nothing backtracks over it anymore, the whole parse fails
+ *    Use it once the tokens already consumed leave no other choice, like after a '('
+ */
+template<typename P>
+struct Commit : ParserTag {
+    using value_type = detail::value_t<P>;
+
+    explicit Commit(P p) : p(std::move(p)) {}
+
+    Result<value_type> operator()(TokenStream& it) const {
+        auto r = p(it);
+        if (has_failed(r))
+            return std::get<ParserError>(r).committed();
+        return r;
+    }
+
+    TokenSet first() const {
+        return p.first();
+    }
+
+    bool nullable() const {
+        return p.nullable();
+    }
+
+    P p;
+};
+
+template<typename P, detail::enable_if_parsers<P> = 0>
+Commit<P> commit(P p) {
+    return Commit<P>(std::move(p));
+}
+
+
+
+
+
+/*
+ * nested (std::size_t, A) -> Nested<A>
+ *    Count a level of nesting in the ParserContext while the parser runs, past 'max_depth' levels it fails with a committed TooDeep error
+ *    Only a token of the FIRST set of the parser opens a level, so the error is on that token, like the one of StackEngine
+ *    Without a ParserContext nothing is counted
+ */
+template<typename P>
+struct Nested : ParserTag {
+    using value_type = detail::value_t<P>;
+
+    Nested(std::size_t max_depth, P p) : max_depth(max_depth), p(std::move(p)) {}
+
+    Result<value_type> operator()(TokenStream& it) const {
+        auto* context = it.context();
+        if (context == nullptr || !(p.nullable() || p.first().intersects(it.peek())))
+            return p(it);
+
+        auto& depth = context->nesting_depth();
+        if (depth >= max_depth)
+            return ParserError::too_deep(it.position()).committed();
+        ++depth;
+        auto r = p(it);
+        --depth;
+        return r;
+    }
+
+    TokenSet first() const {
+        return p.first();
+    }
+
+    bool nullable() const {
+        return p.nullable();
+    }
+
+    std::size_t max_depth;
+    P p;
+};
+
+template<typename P, detail::enable_if_parsers<P> = 0>
+Nested<P> nested(std::size_t max_depth, P p) {
+    return Nested<P>(max_depth, std::move(p));
+}
+
+
+
+
+
+namespace detail {
+
+// Parsers that only match the kind of the next token, the lookaheads test their FIRST set instead of running them
+
+template<typename P>
+constexpr bool is_token_matcher_v = std::is_same_v<P, Eat> || std::is_same_v<P, OneOf>;
+
+template<typename P>
+bool matches(P const& p, TokenStream const& it) {
+    if constexpr (is_token_matcher_v<P>) {
+        return p.first().intersects(it.peek());
+    } else {
+        return !has_failed(ws::parser::internal::probe(p, it));
+    }
+}
+
+}
+
+
+
+
+
+/*
+ * peek (A) -> Peek<A>
+ *    Succeed if the parser succeeds, nothing is consumed and no result is built
+ *    The FIRST set is the one of A: it is the next token tested, even if it is not consumed
+ *    It is nullable, it never consumes
+ */
+template<typename P>
+struct Peek : ParserTag {
+    using value_type = std::monostate;
+
+    explicit Peek(P p) : p(std::move(p)) {}
+
+    Result<std::monostate> operator()(TokenStream& it) const {
+        if (detail::matches(p, it))
+            return std::monostate();
+        return ws::parser::internal::fail(it, p.first());
+    }
+
+    TokenSet first() const {
+        return p.first();
+    }
+
+    bool nullable() const {
+        return true;
+    }
+
+    P p;
+};
+
+template<typename P, detail::enable_if_parsers<P> = 0>
+Peek<P> peek(P p) {
+    return Peek<P>(std::move(p));
+}
+
+
+
+
+
+/*
+ * not_ (A) -> Not<A>
+ *    Succeed if the parser fails, nothing is consumed
+ *    It is nullable and any token can be next, except the ones A would accept, that is not a set of tokens
+ */
+template<typename P>
+struct Not : ParserTag {
+    using value_type = std::monostate;
+
+    explicit Not(P p) : p(std::move(p)) {}
+
+    Result<std::monostate> operator()(TokenStream& it) const {
+        if (!detail::matches(p, it))
+            return std::monostate();
+        return ParserError::error(it.position());
+    }
+
+    TokenSet first() const {
+        return TokenSet::all();
+    }
+
+    bool nullable() const {
+        return true;
+    }
+
+    P p;
+};
+
+template<typename P, detail::enable_if_parsers<P> = 0>
+Not<P> not_(P p) {
+    return Not<P>(std::move(p));
+}
+
+
+
+
+
+/*
+ * lookahead (std::size_t, TokenSet) -> Lookahead
+ *    Succeed if the n-th next token is one of the set, lookahead(1, ...) tests the next token, nothing is consumed nor copied
+ *    n starts at 1, there is no token before the next one
+ */
+struct Lookahead : ParserTag {
+    using value_type = std::monostate;
+
+    Lookahead(std::size_t n, TokenSet kinds) : n(n), kinds(kinds) {
+        assert(n > 0 && "lookahead: the next token is the first one, n starts at 1");
+    }
+
+    Result<std::monostate> operator()(TokenStream& it) const {
+        if (kinds.intersects(it.peek(n - 1)))
+            return std::monostate();
+        return ws::parser::internal::fail(it, kinds, n - 1);
+    }
+
+    // Only the next token is known when n is 1, and it is not consumed
+
+    TokenSet first() const {
+        return n == 1 ? kinds : TokenSet::all();
+    }
+
+    bool nullable() const {
+        return true;
+    }
+
+    std::size_t n;
+    TokenSet kinds;
+};
+
+inline Lookahead lookahead(std::size_t n, TokenSet kinds) {
+    return Lookahead(n, kinds);
+}
+
+
+
+
+
+/*
+ * join (std::variant<A...>) -> Join<B, P>
+ *    Run the parser and convert the result into B, the first type of the variant, All types in the variant need to be convertible to B
+ */
+template<typename T, typename P>
+struct Join : ParserTag {
+    using value_type = T;
+
+    explicit Join(P p) : p(std::move(p)) {}
+
+    Result<T> operator()(TokenStream& it) const {
+        auto r = p(it);
+        if (has_failed(r))
+            return std::get<ParserError>(r);
+        return std::visit([] (auto& a) -> T { return std::move(a); }, std::get<1>(r));
+    }
+
+    TokenSet first() const {
+        return p.first();
+    }
+
+    bool nullable() const {
+        return p.nullable();
+    }
+
+    P p;
+};
+
+template<typename P, detail::enable_if_parsers<P> = 0>
+Join<std::variant_alternative_t<0, detail::value_t<P>>, P> join(P p) {
+    return Join<std::variant_alternative_t<0, detail::value_t<P>>, P>(std::move(p));
+}
+
+
+
+
+
+/*
+ * memo (A) -> Memo<A>
+ *    Packrat memoization, when the ParserContext of the stream enables it, the parser is run at most once per token and the result is reused
+ *    A must be copyable, or a std::unique_ptr to a type with a 'clone' method
+ */
+template<typename P>
+struct Memo : ParserTag {
+    using value_type = detail::value_t<P>;
+
+    explicit Memo(P p) : id(ws::parser::internal::next_memo_id()), p(std::move(p)) {}
+
+    Result<value_type> operator()(TokenStream& it) const {
+        return ws::parser::internal::memoize<value_type>(id, it, p);
+    }
+
+    TokenSet first() const {
+        return p.first();
+    }
+
+    bool nullable() const {
+        return p.nullable();
+    }
+
+    std::size_t id;
+    P p;
+};
+
+template<typename P, detail::enable_if_parsers<P> = 0>
+Memo<P> memo(P p) {
+    return Memo<P>(std::move(p));
+}
+
+
+
+
+
+/*
+ * log (std::string, A) -> Log<A>
+ *    Send an event to the TraceSink of the ParserContext when the parser is run, and when it succeed/fail, returns the result of that parser
+ *    The type A need to implement operator<<(std::ostream&), the value is only printed if the sink prints it
+ *    Nothing is traced without a sink, and the tracing is compiled out when WS_PARSER_TRACE is 0
+ */
+template<typename P>
+struct Log : ParserTag {
+    using value_type = detail::value_t<P>;
+
+    Log(std::string name, P p) : name(std::move(name)), p(std::move(p)) {}
+
+    Result<value_type> operator()(TokenStream& it) const {
+        return ws::parser::internal::traced<value_type>(name, it, p);
+    }
+
+    TokenSet first() const {
+        return p.first();
+    }
+
+    bool nullable() const {
+        return p.nullable();
+    }
+
+    std::string name;
+    P p;
+};
+
+template<typename P, detail::enable_if_parsers<P> = 0>
+Log<P> log(std::string const& name, P p) {
+    return Log<P>(name, std::move(p));
+}
+
+
+
+
+
+/*
+ * Rule<A>
+ *    Type erased parser of A, declare it first, reference it with ref or ~, and assign it later
+ *    The parser is stored inline up to Rule<A>::capacity bytes, a larger one is allocated
+ */
+template<typename T>
+class Rule : public ParserTag {
+public:
+    using value_type = T;
+
+    static constexpr std::size_t capacity = 512;
+
+    Rule() = default;
+
+    template<typename P, detail::enable_if_parsers<P> = 0>
+    Rule(P p) : first_set(p.first()), is_nullable(p.nullable()), parser(std::move(p)) {
+        static_assert(std::is_same_v<detail::value_t<P>, T>, "Rule<T> can only hold a parser of T");
+    }
+
+    template<typename P, detail::enable_if_parsers<P> = 0>
+    Rule& operator=(P p) {
+        static_assert(std::is_same_v<detail::value_t<P>, T>, "Rule<T> can only hold a parser of T");
+        first_set = p.first();
+        is_nullable = p.nullable();
+        parser = std::move(p);
+        return *this;
+    }
+
+    Result<T> operator()(TokenStream& it) const {
+        return parser(it);
+    }
+
+    // The FIRST set of the parser assigned, conservative until then
+
+    TokenSet first() const {
+        return first_set;
+    }
+
+    bool nullable() const {
+        return is_nullable;
+    }
+
+private:
+
+    TokenSet first_set = TokenSet::all();
+    bool is_nullable = true;
+    AnyParser<T, capacity> parser;
+
+};
+
+
+
+
+
+/*
+ * ref (Rule<A>) -> Ref<A>
+ *    Reference a rule without copying it, needed for recursion, the rule must outlive the parser
+ */
+template<typename T>
+struct Ref : ParserTag {
+    using value_type = T;
+
+    explicit Ref(Rule<T> const& rule) : rule(&rule) {}
+
+    Result<T> operator()(TokenStream& it) const {
+        return (*rule)(it);
+    }
+
+    TokenSet first() const {
+        return rule->first();
+    }
+
+    bool nullable() const {
+        return rule->nullable();
+    }
+
+    Rule<T> const* rule;
+};
+
+template<typename T>
+Ref<T> ref(Rule<T> const& rule) {
+    return Ref<T>(rule);
+}
+
+
+
+
+
+/*
+ * operator ~ (Rule<A>) -> Ref<A>
+ *    Equivalent of 'ref'
+ */
+template<typename T>
+Ref<T> operator~(Rule<T> const& rule) {
+    return ref(rule);
+}
+
+
+
+
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <ws/parser/ParserResult.hpp>
+
+/*
+ * WS_PARSER_TRACE
+ *    0 compiles the tracing of the 'log' combinators out entirely, 'log' is then just its parser
+ *    1 (default) keeps it, a parse is only traced when its ParserContext has a TraceSink
+ */
+#ifndef WS_PARSER_TRACE
+#define WS_PARSER_TRACE 1
+#endif
+
+namespace ws::parser {
+
+constexpr bool trace_compiled = WS_PARSER_TRACE;
+
+/*
+ * TraceValue
+ *    Value produced by a traced rule, only valid during TraceSink::record
+ *    Printing it formats the parsed value (or the error), nothing is formatted if the sink doesn't print it
+ */
+struct TraceValue {
+    void const* object = nullptr;
+    void (*print)(std::ostream&, void const*) = nullptr;
+};
+
+std::ostream& operator<<(std::ostream& os, TraceValue const& value);
+
+/*
+ * TraceEvent
+ *    A rule named by 'log' began, succeeded, failed or threw at 'position' in the token stream
+ *    'rule' points to the name stored in the grammar, it is valid as long as the grammar lives
+ */
+struct TraceEvent {
+    enum class Kind : std::uint8_t {
+        Begin, Success, Failure, Exception
+    };
+
+    Kind kind;
+    std::uint32_t depth;
+    std::size_t position;
+    std::string const* rule;
+};
+
+std::ostream& operator<<(std::ostream& os, TraceEvent const& event);
+
+/*
+ * TraceSink
+ *    Receive the events of the traced parses, set it on a ParserContext
+ */
+class TraceSink {
+public:
+    virtual ~TraceSink() = default;
+
+    virtual void record(TraceEvent const& event, TraceValue const& value) = 0;
+};
+
+/*
+ * ConsoleTraceSink
+ *    Print each event with the values on the console, indented by depth
+ */
+class ConsoleTraceSink : public TraceSink {
+public:
+    void record(TraceEvent const& event, TraceValue const& value) override;
+};
+
+/*
+ * RingTraceSink
+ *    Keep the last 'capacity' events in a buffer allocated once, the values are not formatted
+ */
+class RingTraceSink : public TraceSink {
+public:
+    explicit RingTraceSink(std::size_t capacity);
+
+    void record(TraceEvent const& event, TraceValue const& value) override;
+
+    std::vector<TraceEvent> events() const;
+    std::size_t dropped() const;
+    void clear();
+
+private:
+    std::vector<TraceEvent> buffer;
+    std::size_t next = 0;
+    std::size_t count = 0;
+};
+
+}
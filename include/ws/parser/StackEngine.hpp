@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <ws/parser/token/TokenBuffer.hpp>
+#include <ws/parser/ParserResult.hpp>
+#include <ws/parser/ParserContext.hpp>
+#include <ws/parser/IncrementalParser.hpp>
+
+namespace ws::parser {
+
+/*
+ * StackEngine
+ *    Precedence climbing parser driven by an OperatorTable, without recursion, the pending operators live in a stack on the heap
+ *    The nesting depth, every '(' and every prefix operator, is limited by a budget instead of the size of the thread stack
+ *    With the calculator table, the default, the ASTs and the errors are the same as the ones of ParserEngine,
+ *    plus a TooDeep error over the budget
+ *    The engine is immutable, so a single engine can be shared between threads
+ *    The context only keeps the furthest failure, there is no packrat memo nor trace in this engine
+ *    A parse is an IncrementalParser fed with all the tokens at once, 'incremental' gives one to feed chunk by chunk
+ */
+class StackEngine {
+public:
+
+    static constexpr std::size_t default_max_depth = 10000;
+
+    explicit StackEngine(std::size_t max_depth = default_max_depth);
+    explicit StackEngine(OperatorTable table, std::size_t max_depth = default_max_depth);
+
+    std::size_t max_depth() const;
+
+    IncrementalParser incremental() const;
+
+    ParserResult parse(TokenView const& tokens) const;
+    ParserResult parse(TokenView const& tokens, ParserContext& context) const;
+
+    // A slice [begin, end) of the tokens, without copy
+    ParserResult parse(TokenView const& tokens, std::size_t begin, std::size_t end) const;
+    ParserResult parse(TokenView const& tokens, std::size_t begin, std::size_t end, ParserContext& context) const;
+
+private:
+
+    std::shared_ptr<OperatorTable const> table;
+    std::size_t depth_budget;
+
+};
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <memory>
 #include <json.hpp>
 
 namespace ws::parser {
@@ -12,6 +13,8 @@ public:
 
     virtual std::ostream& dump(std::ostream& os) const = 0;
 
+    virtual std::unique_ptr<AST> clone() const = 0;
+
 private:
 
 };
@@ -3,6 +3,7 @@
 #include <memory>
 
 #include <ws/parser/ast/AST.hpp>
+#include <ws/parser/token/TokenType.hpp>
 
 namespace ws::parser {
 
@@ -10,11 +11,15 @@ class BinaryOperator : public AST {
 public:
 
     BinaryOperator(std::string const& name, std::unique_ptr<AST> lhs, std::unique_ptr<AST> rhs);
+    // Named after the operator: plus, subtract, multiplication or division, any other kind is a bug of the grammar
+    BinaryOperator(TokenKind op, std::unique_ptr<AST> lhs, std::unique_ptr<AST> rhs);
 
     nlohmann::json compile() const override;
 
     std::ostream& dump(std::ostream& os) const override;
 
+    std::unique_ptr<AST> clone() const override;
+
 private:
 
     std::string name;
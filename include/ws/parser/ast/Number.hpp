@@ -7,15 +7,21 @@ namespace ws::parser {
 class Number : public AST {
 public:
 
-    Number(std::string const& value);
+    // The value is the one read from the literal at ingest, the text is kept as written
+    Number(std::string const& text, double value);
 
     nlohmann::json compile() const override;
 
     std::ostream& dump(std::ostream& os) const override;
 
+    std::unique_ptr<AST> clone() const override;
+
+    double value() const;
+
 private:
 
-    std::string value;
+    std::string text;
+    double number;
 
 };
 
@@ -15,6 +15,8 @@ public:
 
     std::ostream& dump(std::ostream& os) const override;
 
+    std::unique_ptr<AST> clone() const override;
+
 private:
 
     std::string name;
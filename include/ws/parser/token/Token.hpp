@@ -1,6 +1,8 @@
 #pragma once
 
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include <ws/parser/token/TokenType.hpp>
 
@@ -10,11 +12,16 @@ class Token {
 public:
 
     Token() = default;
+    Token(std::string const& content, TokenKind kind, std::size_t line, std::size_t column);
     Token(std::string const& content, TokenType type, TokenSubType subtype, std::size_t line, std::size_t column);
 
+    TokenType type() const;
+    TokenSubType subtype() const;
+
     std::string content;
-    TokenType type;
-    TokenSubType subtype;
+    TokenKind kind;
+    // The value of a float literal, read once from the content, nullopt if it is not a numeral, 0 for the other kinds
+    std::optional<double> value = 0.;
 
     std::size_t line;
     std::size_t column;
@@ -23,4 +30,11 @@ public:
 
 std::ostream& operator<<(std::ostream& os, Token const& token);
 
+// The value of the whole content with std::from_chars, locale free, nullopt if it is not a finite numeral
+// A numeral too small for a double is read as 0, with its sign, a numeral too large is not finite
+std::optional<double> read_float(std::string_view content);
+
+// The value of a token: the one of the content for a float literal, nullopt if it is not a numeral, 0 otherwise
+std::optional<double> literal_value(TokenKind kind, std::string_view content);
+
 }
\ No newline at end of file
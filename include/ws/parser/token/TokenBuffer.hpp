@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <ws/parser/token/Token.hpp>
+#include <ws/parser/token/TokenSet.hpp>
+#include <ws/parser/token/TokenView.hpp>
+
+namespace ws::parser {
+
+/*
+ * TokenBuffer
+ *    Tokens stored column by column instead of one Token object each:
+ *        the kinds, one byte each, scanned by the parsers
+ *        the contents, an offset and a length in a single pool of characters, or in the source
+ *        the positions, a 32 bits offset resolved into a line and a column by a table of the line starts
+ *        no value: a float literal is checked to be a numeral when it is pushed (see literal_value), and read again
+ *        when its AST is built, a column of values would add 8 bytes to every token
+ *    So a token is 13 bytes plus its content, and the kinds of the tokens are contiguous
+ *    With a source, the contents pushed with 'push_back_view' are views into it, nothing is copied,
+ *    the source must outlive the buffer
+ *    The pool and the source are limited to 2 GiB each, the offsets to 4 GiB, a content or a position past them is refused
+ *    instead of aliasing another one
+ *    A line start is added each time the line changes from a token to the next, so the tokens on alternating lines
+ *    take one more line start each (8 bytes), and each new line starts after the largest column so far: 
+ *    large columns on many lines run out of offsets long before 4 Gi tokens
+ *    The buffer is a TokenView of its columns, what the parsers read
+ */
+class TokenBuffer : public TokenView {
+public:
+
+    TokenBuffer() = default;
+    explicit TokenBuffer(std::vector<Token> const& tokens);
+    explicit TokenBuffer(std::string_view source);
+
+    // The view is of the own columns of the buffer, not of the columns copied or moved from
+    TokenBuffer(TokenBuffer const& other);
+    TokenBuffer(TokenBuffer&& other) noexcept;
+    TokenBuffer& operator=(TokenBuffer const& other);
+    TokenBuffer& operator=(TokenBuffer&& other) noexcept;
+
+    void reserve(std::size_t count, std::size_t content_size = 0);
+    // A token that does not fit in the limits, or a float literal that is not a numeral, is not pushed, the push returns false
+    bool push_back(std::string_view content, TokenKind kind, std::size_t line, std::size_t column);
+    bool push_back(std::string_view content, TokenType type, TokenSubType subtype, std::size_t line, std::size_t column);
+    bool push_back(Token const& token);
+    // The content is source().substr(offset, length), it is not copied, it must be in the source
+    bool push_back_view(std::size_t offset, std::size_t length, TokenKind kind, std::size_t line, std::size_t column);
+    void clear();
+
+    // A token at this position gets an offset in the 32 bits, pushed after the tokens already in the buffer
+    bool is_reachable(std::size_t line, std::size_t column) const;
+
+    // The limits of the contents checked by the pushes, from the sizes only:
+    // 'length' characters after the 'used' ones of the pool, or at 'offset' in a source of 'source_size' characters
+    static bool fits_in_pool(std::size_t used, std::size_t length);
+    static bool fits_in_source(std::size_t source_size, std::size_t offset, std::size_t length);
+
+private:
+
+    // Points the view at the columns, after each change of the vectors or of the pool
+    void refresh();
+
+    std::optional<std::uint32_t> offset_at(std::size_t line, std::size_t column) const;
+    std::uint32_t offset_of(std::size_t line, std::size_t column);
+
+    std::vector<TokenKind> kinds;
+    std::vector<Span> contents;
+    std::vector<std::uint32_t> offsets;
+    std::vector<LineStart> line_starts;
+    std::uint32_t end_offset = 0;
+    std::string pool;
+
+};
+
+}
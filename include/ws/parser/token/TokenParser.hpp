@@ -1,11 +1,13 @@
 #pragma once
 
 #include <ws/parser/token/Token.hpp>
+#include <ws/parser/token/TokenBuffer.hpp>
 
 #include <json.hpp>
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <initializer_list>
 #include <variant>
 
@@ -65,6 +67,17 @@ public:
 
 };
 
+class InvalidJson : public TokenParsingError {
+public:
+    InvalidJson(std::string const& message);
+
+    virtual std::string what() const override;
+
+private:
+    std::string message;
+
+};
+
 class UnreachablePosition : public TokenParsingError {
 public:
     UnreachablePosition(std::string const& key, json_t::number_integer_t position);
@@ -77,12 +90,53 @@ private:
 
 };
 
-using TokenParserResult = std::variant<std::vector<ws::parser::Token>, std::unique_ptr<TokenParsingError>>;
+// A float literal whose content is not a numeral, found at ingest instead of by the consumers of the value
+class InvalidNumeral : public TokenParsingError {
+public:
+    InvalidNumeral(std::string const& content, std::size_t line, std::size_t column);
+
+    virtual std::string what() const override;
+
+private:
+    std::string content;
+    std::size_t line, column;
+
+};
+
+// A token whose content is past the 2 GiB of the pool or of the source, refused by the TokenBuffer
+class ContentOutOfBounds : public TokenParsingError {
+public:
+    ContentOutOfBounds(std::size_t line, std::size_t column);
+
+    virtual std::string what() const override;
+
+private:
+    std::size_t line, column;
+
+};
+
+// A token whose line or offset is past the 32 bits of the token buffer, see TokenBuffer for the offsets of the lines
+class PositionOutOfBounds : public TokenParsingError {
+public:
+    PositionOutOfBounds(std::size_t line, std::size_t column);
+
+    virtual std::string what() const override;
+
+private:
+    std::size_t line, column;
+
+};
+
+using TokenParserResult = std::variant<TokenBuffer, std::unique_ptr<TokenParsingError>>;
 using SingleTokenParserResult = std::variant<Token, std::unique_ptr<TokenParsingError>>;
 
 SingleTokenParserResult parse_token(json_t const& json);
 TokenParserResult parse_tokens(json_t const& json);
 
+// Read the tokens straight from the JSON text, without building the JSON document
+// The contents are views into the input when they have no escape sequence, the input must outlive the tokens
+TokenParserResult parse_tokens_in_place(std::string_view input);
+
 bool is_error(SingleTokenParserResult const& res);
 bool is_error(TokenParserResult const& res);
 
@@ -92,8 +146,8 @@ std::unique_ptr<TokenParsingError>* get_error(SingleTokenParserResult& error);
 Token* get_token(SingleTokenParserResult& error);
 
 std::unique_ptr<TokenParsingError> const* get_error(TokenParserResult const& error);
-std::vector<ws::parser::Token> const* get_tokens(TokenParserResult const& error);
+TokenBuffer const* get_tokens(TokenParserResult const& error);
 std::unique_ptr<TokenParsingError>* get_error(TokenParserResult& error);
-std::vector<ws::parser::Token>* get_tokens(TokenParserResult& error);
+TokenBuffer* get_tokens(TokenParserResult& error);
 
 }
\ No newline at end of file
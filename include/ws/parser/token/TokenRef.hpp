@@ -0,0 +1,63 @@
+#pragma once
+
+#include <ostream>
+#include <string_view>
+
+#include <ws/parser/token/TokenView.hpp>
+
+namespace ws::parser {
+
+/*
+ * TokenRef
+ *    What eat and one_of return: a reference to a token of the input instead of a copy of it
+ *    The input is never modified while it is parsed, the token is only read when an AST node needs its content
+ */
+class TokenRef {
+public:
+
+    TokenRef(TokenView const& tokens, std::size_t index) : tokens(&tokens), token_index(index) {}
+
+    std::string_view content() const {
+        return tokens->content(token_index);
+    }
+
+    TokenKind kind() const {
+        return tokens->kind(token_index);
+    }
+
+    TokenType type() const {
+        return tokens->type(token_index);
+    }
+
+    TokenSubType subtype() const {
+        return tokens->subtype(token_index);
+    }
+
+    // The value of a float literal
+    double value() const {
+        return tokens->value(token_index);
+    }
+
+    std::size_t line() const {
+        return tokens->line(token_index);
+    }
+
+    std::size_t column() const {
+        return tokens->column(token_index);
+    }
+
+    // Index of the token in its TokenView
+    std::size_t index() const {
+        return token_index;
+    }
+
+private:
+
+    TokenView const* tokens;
+    std::size_t token_index;
+
+};
+
+std::ostream& operator<<(std::ostream& os, TokenRef token);
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+
+#include <ws/parser/token/Token.hpp>
+
+namespace ws::parser {
+
+/*
+ * TokenSet
+ *    Set of token kinds, plus the end of the stream, stored in a bitmask, the bit of a kind is its index
+ *    Used for the FIRST sets of the parsers
+ */
+class TokenSet {
+public:
+
+    constexpr TokenSet() = default;
+
+    static constexpr TokenSet of(TokenKind kind) {
+        return TokenSet(std::uint32_t(1) << index_of(kind));
+    }
+
+    static constexpr TokenSet of(TokenType type, TokenSubType subtype) {
+        return of(kind_of(type, subtype));
+    }
+
+    static constexpr TokenSet end_of_stream() {
+        return TokenSet(end_of_stream_bit);
+    }
+
+    static constexpr TokenSet all() {
+        return TokenSet(~std::uint32_t(0));
+    }
+
+    // Kind of the token, or the end of the stream if there is no token
+    static constexpr TokenSet of(Token const* token) {
+        return token ? of(token->kind) : end_of_stream();
+    }
+
+    constexpr bool empty() const {
+        return bits == 0;
+    }
+
+    constexpr bool intersects(TokenSet other) const {
+        return (bits & other.bits) != 0;
+    }
+
+    constexpr TokenSet operator|(TokenSet other) const {
+        return TokenSet(bits | other.bits);
+    }
+
+    constexpr TokenSet operator&(TokenSet other) const {
+        return TokenSet(bits & other.bits);
+    }
+
+    constexpr bool operator==(TokenSet other) const {
+        return bits == other.bits;
+    }
+
+    constexpr bool operator!=(TokenSet other) const {
+        return bits != other.bits;
+    }
+
+private:
+
+    static constexpr std::uint32_t end_of_stream_bit = std::uint32_t(1) << 31;
+
+    static_assert(token_kind_count <= 31, "Too many token kinds for TokenSet");
+
+    constexpr explicit TokenSet(std::uint32_t bits) : bits(bits) {}
+
+    std::uint32_t bits = 0;
+
+};
+
+// Each kind of the set between backquotes, separated by commas
+std::ostream& operator<<(std::ostream& os, TokenSet set);
+
+}
@@ -1,20 +1,37 @@
 #pragma once
 
-#include <vector>
-
-#include <ws/parser/token/Token.hpp>
+#include <ws/parser/token/TokenView.hpp>
+#include <ws/parser/token/TokenRef.hpp>
+#include <ws/parser/token/TokenSet.hpp>
 
 namespace ws::parser {
 
+class ParserContext;
+
+/*
+ * TokenStream
+ *    Cursor over the tokens of a TokenView (a TokenBuffer or a view of other columns), all of them or a slice [begin, end)
+ *    The tokens are never copied, they must outlive the stream, the positions count from the beginning of the slice
+ */
 class TokenStream {
 public:
-    using iterator = typename std::vector<Token>::const_iterator;
 
-    TokenStream(iterator begin, iterator end);
+    explicit TokenStream(TokenView const& tokens, ParserContext* context = nullptr);
+    TokenStream(TokenView const& tokens, std::size_t begin, std::size_t end, ParserContext* context = nullptr);
 
     bool is_end_of_stream() const;
-    Token const& operator*() const;
-    Token const* operator->() const;
+    std::size_t position() const;
+    std::size_t size() const;
+    ParserContext* context() const;
+
+    // Kind of the next token, or the end of the stream, the token itself is not read
+    TokenSet peek() const;
+    // Kind of the token 'offset' positions after the next one, peek(0) is peek()
+    TokenSet peek(std::size_t offset) const;
+
+    // The next token, the stream must not be at its end, it is asserted
+    TokenRef token() const;
+
     TokenStream& operator++();
     TokenStream& operator--();
     TokenStream operator++(int);
@@ -22,9 +39,11 @@ public:
 
 private:
 
-    iterator begin, end;
+    TokenView const* tokens;
+    std::size_t origin, begin, end;
+    ParserContext* parser_context;
 
 };
 
 
-}
\ No newline at end of file
+}
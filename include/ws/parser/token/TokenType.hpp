@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cassert>
+#include <cstdint>
 #include <iostream>
 
 namespace ws::parser {
@@ -22,4 +24,54 @@ enum class TokenSubType {
 
 std::ostream& operator<<(std::ostream& os, TokenSubType subtype);
 
+/*
+ * TokenKind
+ *    The type and the subtype of a token in a single byte, numbered densely from 0
+ *    Every subtype belongs to a single type, so a kind is numbered as its subtype and the type is implied
+ *    The dispatch tables and the bits of TokenSet are indexed by kind
+ */
+enum class TokenKind : std::uint8_t {
+    ParenthesisLeft, ParenthesisRight,
+    OperatorPlus, OperatorMinus, OperatorMultiplication, OperatorDivision,
+    LiteralFloat
+
+};
+
+constexpr std::size_t token_kind_count = static_cast<std::size_t>(TokenKind::LiteralFloat) + 1;
+
+static_assert(static_cast<std::size_t>(TokenSubType::Float) + 1 == token_kind_count, "A kind per subtype");
+
+constexpr TokenSubType subtype_of(TokenKind kind) {
+    return static_cast<TokenSubType>(kind);
+}
+
+constexpr TokenType type_of(TokenKind kind) {
+    switch(kind) {
+        case TokenKind::ParenthesisLeft:
+        case TokenKind::ParenthesisRight:
+            return TokenType::Parenthesis;
+        case TokenKind::LiteralFloat:
+            return TokenType::Literal;
+        default:
+            return TokenType::Operator;
+    }
+}
+
+constexpr bool is_subtype_of(TokenSubType subtype, TokenType type) {
+    return type_of(static_cast<TokenKind>(subtype)) == type;
+}
+
+// The type must be the one of the subtype, it is asserted: without NDEBUG a mismatch in a constant expression does not compile
+constexpr TokenKind kind_of(TokenType type, TokenSubType subtype) {
+    assert(is_subtype_of(subtype, type) && "kind_of: the subtype is not one of the type");
+    return static_cast<TokenKind>(subtype);
+}
+
+constexpr std::size_t index_of(TokenKind kind) {
+    return static_cast<std::size_t>(kind);
+}
+
+// Printed as its type and its subtype: 'operator.plus'
+std::ostream& operator<<(std::ostream& os, TokenKind kind);
+
 }
\ No newline at end of file
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <string_view>
+
+#include <ws/parser/token/Token.hpp>
+#include <ws/parser/token/TokenType.hpp>
+
+namespace ws::parser {
+
+/*
+ * TokenView
+ *    Non owning view of tokens stored column by column, what the parsers and the engines read, see TokenBuffer for the columns
+ *    A TokenBuffer is the view of its own columns, any other memory laid out the same way (an arena, a mapped file,
+ *    the arrays of a lexer) is parsed in place through a view of its columns, nothing is copied
+ *    The columns must outlive the view and everything parsed from it
+ */
+class TokenView {
+public:
+
+    // The highest bit of the offset of a content tells if it is in the source or in the pool
+    static constexpr std::uint32_t in_source = std::uint32_t(1) << 31;
+
+    struct Span {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    // The line of the offsets from 'offset' up to the next line start, the line starts are increasing
+    struct LineStart {
+        std::uint32_t offset;
+        std::uint32_t line;
+    };
+
+    // 'size' entries in each column of the tokens, 'line_count' line starts, the first one at offset 0
+    struct Columns {
+        std::size_t size = 0;
+        TokenKind const* kinds = nullptr;
+        Span const* contents = nullptr;
+        std::uint32_t const* offsets = nullptr;
+        LineStart const* line_starts = nullptr;
+        std::size_t line_count = 0;
+        char const* pool = nullptr;
+        std::string_view source;
+    };
+
+    TokenView() = default;
+    explicit TokenView(Columns const& columns) : columns(columns) {
+        assert(has_valid_line_starts(columns) && "TokenView: the line starts must increase from offset 0");
+    }
+
+    // The line starts increase from offset 0, so each offset is on a line, it is asserted when the view is built
+    // Without, an offset before the first line start is on line 0 and its column is the offset
+    static bool has_valid_line_starts(Columns const& columns);
+
+    std::string_view source() const {
+        return columns.source;
+    }
+
+    // The accessors are read by the parsers for each token, they are inlined
+
+    std::size_t size() const {
+        return columns.size;
+    }
+
+    bool empty() const {
+        return columns.size == 0;
+    }
+
+    TokenKind kind(std::size_t index) const {
+        return columns.kinds[index];
+    }
+
+    TokenType type(std::size_t index) const {
+        return type_of(columns.kinds[index]);
+    }
+
+    TokenSubType subtype(std::size_t index) const {
+        return subtype_of(columns.kinds[index]);
+    }
+
+    std::string_view content(std::size_t index) const {
+        auto span = columns.contents[index];
+        if (span.offset & in_source)
+            return std::string_view(columns.source.data() + (span.offset & ~in_source), span.length);
+        return std::string_view(columns.pool + span.offset, span.length);
+    }
+
+    // Read from the content when the AST is built, a float literal of a view must be a numeral, like in a TokenBuffer
+    double value(std::size_t index) const {
+        if (columns.kinds[index] != TokenKind::LiteralFloat)
+            return 0;
+        auto value = read_float(content(index));
+        assert(value && "TokenView: a float literal is not a numeral");
+        return value.value_or(0);
+    }
+
+    // The positions are only read to report an error, they are searched in the line starts
+
+    struct Position {
+        std::size_t line;
+        std::size_t column;
+    };
+
+    Position position(std::size_t index) const;
+
+    std::size_t line(std::size_t index) const {
+        return position(index).line;
+    }
+
+    std::size_t column(std::size_t index) const {
+        return position(index).column;
+    }
+
+    std::size_t offset(std::size_t index) const {
+        return columns.offsets[index];
+    }
+
+    // A copy of the token, with its own content
+    Token token(std::size_t index) const;
+
+protected:
+
+    Columns columns;
+
+};
+
+}
\ No newline at end of file
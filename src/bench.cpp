@@ -0,0 +1,247 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <string>
+#include <new>
+#include <cstdlib>
+
+#include <module/module.h>
+#include <ws/parser/ParserInternal.hpp>
+#include <ws/parser/ParserStatic.hpp>
+#include <ws/parser/StackEngine.hpp>
+#include <ws/parser/ast/Number.hpp>
+#include <ws/parser/ast/BinaryOperator.hpp>
+#include <ws/parser/ast/UnaryOperator.hpp>
+
+// Every allocation of the process is counted, to report the allocations per token
+
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+using ws::parser::TokenRef;
+using ws::parser::TokenBuffer;
+using ws::parser::TokenType;
+using ws::parser::TokenSubType;
+using ws::parser::AST_ptr;
+
+/*
+ * Both grammars below are the grammar of ParserEngine without the logs:
+ *     expr := factor  (('-' | '+') factor)*
+ *     factor := term (('*' | '/') term)*
+ *     term := '-' term | float | '(' expr ')'
+ */
+
+AST_ptr term_to_AST(std::variant<std::tuple<TokenRef, AST_ptr>, TokenRef, AST_ptr> expr) {
+    if (expr.index() == 0)
+        return std::make_unique<ws::parser::UnaryOperator>("negate", std::move(std::get<1>(std::get<0>(expr))));
+    if (expr.index() == 1)
+        return std::make_unique<ws::parser::Number>(std::string(std::get<1>(expr).content()), std::get<1>(expr).value());
+    return std::move(std::get<2>(expr));
+}
+
+AST_ptr binary_to_AST(AST_ptr lhs, TokenRef op, AST_ptr rhs) {
+    return std::make_unique<ws::parser::BinaryOperator>(op.kind(), std::move(lhs), std::move(rhs));
+}
+
+constexpr auto multiplicative = ws::parser::TokenSet::of(TokenType::Operator, TokenSubType::Multiplication) 
+    | ws::parser::TokenSet::of(TokenType::Operator, TokenSubType::Division);
+constexpr auto additive = ws::parser::TokenSet::of(TokenType::Operator, TokenSubType::Plus) 
+    | ws::parser::TokenSet::of(TokenType::Operator, TokenSubType::Minus);
+
+
+
+// std::function combinators, from ParserInternal.hpp
+
+struct DynamicGrammar {
+
+    DynamicGrammar() {
+        using namespace ws::parser;
+
+        auto minus = eat(TokenType::Operator, TokenSubType::Minus);
+
+        term = map(term_to_AST,
+            (minus & ~term)
+            | eat(TokenType::Literal, TokenSubType::Float)
+            | (eat(TokenType::Parenthesis, TokenSubType::Left) > ~expr < eat(TokenType::Parenthesis, TokenSubType::Right)));
+
+        auto factor = chainl1(term, one_of(multiplicative), binary_to_AST);
+
+        expr = chainl1(factor, one_of(additive), binary_to_AST);
+    }
+
+    bool parse(TokenBuffer const& tokens) const {
+        ws::parser::TokenStream it(tokens);
+        return !ws::parser::has_failed(expr(it)) && it.is_end_of_stream();
+    }
+
+    ws::parser::Parser<AST_ptr> expr;
+    ws::parser::Parser<AST_ptr> term;
+
+};
+
+
+
+// Expression templates combinators, from ParserStatic.hpp
+
+struct StaticGrammar {
+
+    StaticGrammar() {
+        namespace ct = ws::parser::ct;
+
+        auto minus = ct::eat(TokenType::Operator, TokenSubType::Minus);
+
+        term = map(term_to_AST,
+            (minus & ~term)
+            | ct::eat(TokenType::Literal, TokenSubType::Float)
+            | (ct::eat(TokenType::Parenthesis, TokenSubType::Left) > ~expr < ct::eat(TokenType::Parenthesis, TokenSubType::Right)));
+
+        auto factor = chainl1(~term, ct::one_of(multiplicative), binary_to_AST);
+
+        expr = chainl1(factor, ct::one_of(additive), binary_to_AST);
+    }
+
+    bool parse(TokenBuffer const& tokens) const {
+        ws::parser::TokenStream it(tokens);
+        return !ws::parser::has_failed(expr(it)) && it.is_end_of_stream();
+    }
+
+    ws::parser::ct::Rule<AST_ptr> expr;
+    ws::parser::ct::Rule<AST_ptr> term;
+
+};
+
+
+
+// Same grammar without recursion, from StackEngine.hpp
+
+struct StackGrammar {
+
+    bool parse(TokenBuffer const& tokens) const {
+        return !ws::parser::is_error(engine.parse(tokens));
+    }
+
+    ws::parser::StackEngine engine;
+
+};
+
+
+
+// Random expressions, always parsable
+
+void generate(std::mt19937& rng, TokenBuffer& tokens, int depth) {
+    std::uniform_int_distribution<int> dice(0, 9);
+
+    auto term = [&] {
+        int d = dice(rng);
+        if (depth > 0 && d == 0) {
+            tokens.push_back("-", TokenType::Operator, TokenSubType::Minus, 0, 0);
+            generate(rng, tokens, depth - 1);
+        } else if (depth > 0 && d == 1) {
+            tokens.push_back("(", TokenType::Parenthesis, TokenSubType::Left, 0, 0);
+            generate(rng, tokens, depth - 1);
+            tokens.push_back(")", TokenType::Parenthesis, TokenSubType::Right, 0, 0);
+        } else {
+            tokens.push_back(std::to_string(dice(rng) * 1.5f), TokenType::Literal, TokenSubType::Float, 0, 0);
+        }
+    };
+
+    static constexpr TokenSubType operators[] = { TokenSubType::Plus, TokenSubType::Minus, TokenSubType::Multiplication, TokenSubType::Division };
+    static constexpr char const* symbols[] = { "+", "-", "*", "/" };
+
+    term();
+    for(int i = dice(rng); i > 0; --i) {
+        auto op = dice(rng) % 4;
+        tokens.push_back(symbols[op], TokenType::Operator, operators[op], 0, 0);
+        term();
+    }
+}
+
+// Expressions nested through 'depth' parenthesis or unary '-'
+
+void generate_deep(std::mt19937& rng, TokenBuffer& tokens, int depth) {
+    std::uniform_int_distribution<int> dice(0, 1);
+    int closing = 0;
+    for(int i = 0; i < depth; ++i) {
+        if (dice(rng)) {
+            tokens.push_back("-", TokenType::Operator, TokenSubType::Minus, 0, 0);
+        } else {
+            tokens.push_back("(", TokenType::Parenthesis, TokenSubType::Left, 0, 0);
+            ++closing;
+        }
+    }
+    tokens.push_back("1.5", TokenType::Literal, TokenSubType::Float, 0, 0);
+    for(; closing > 0; --closing)
+        tokens.push_back(")", TokenType::Parenthesis, TokenSubType::Right, 0, 0);
+}
+
+template<typename Grammar>
+void bench(std::string const& name, std::vector<TokenBuffer> const& corpus, std::size_t token_count, int rounds) {
+    auto allocations_before = allocations;
+    Grammar const grammar;
+    auto build_allocations = allocations - allocations_before;
+
+    std::size_t parsed = 0;
+    allocations_before = allocations;
+    auto begin = std::chrono::steady_clock::now();
+    for(int r = 0; r < rounds; ++r)
+        for(auto const& tokens : corpus)
+            parsed += grammar.parse(tokens);
+    auto end = std::chrono::steady_clock::now();
+
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    auto total_tokens = static_cast<double>(token_count * rounds);
+    ws::module::println(name, ": ", ns / 1000000, " ms, ",
+        static_cast<double>(ns) / total_tokens, " ns/token, ", 
+        static_cast<double>(allocations - allocations_before) / total_tokens, " allocations/token (", parsed, " parsed, ", build_allocations, " allocations to build)");
+}
+
+int main(int argc, char** argv) {
+    int rounds = argc > 1 ? std::stoi(argv[1]) : 20;
+
+    std::mt19937 rng(42);
+    std::vector<TokenBuffer> corpus(2000);
+    std::size_t token_count = 0;
+    std::size_t node_count = 0;
+    for(auto& tokens : corpus) {
+        generate(rng, tokens, 4);
+        token_count += tokens.size();
+        for(std::size_t i = 0; i < tokens.size(); ++i)
+            node_count += tokens.type(i) != TokenType::Parenthesis;
+    }
+
+    // Each token other than a parenthesis becomes an AST node, one allocation each whatever the combinators
+    ws::module::println(corpus.size(), " expressions, ", token_count, " tokens, ", rounds, " rounds, ", 
+        static_cast<double>(node_count) / static_cast<double>(token_count), " AST nodes/token");
+
+    bench<DynamicGrammar>("std::function combinators      ", corpus, token_count, rounds);
+    bench<StaticGrammar>("expression template combinators", corpus, token_count, rounds);
+    bench<StackGrammar>("explicit stack engine          ", corpus, token_count, rounds);
+
+    std::vector<TokenBuffer> deep_corpus(20);
+    std::size_t deep_token_count = 0;
+    for(auto& tokens : deep_corpus) {
+        generate_deep(rng, tokens, 5000);
+        deep_token_count += tokens.size();
+    }
+
+    ws::module::println(deep_corpus.size(), " deep expressions, ", deep_token_count, " tokens, ", rounds, " rounds");
+
+    bench<StackGrammar>("explicit stack engine          ", deep_corpus, deep_token_count, rounds);
+
+    return 0;
+}
@@ -5,14 +5,22 @@
 
 #include <module/module.h>
 #include <json.hpp>
-#include <ws/parser/Parser.hpp>
+#include <ws/parser/ParserEngine.hpp>
+#include <ws/parser/StackEngine.hpp>
+#include <ws/parser/ParserTrace.hpp>
+#include <ws/parser/ParserProfile.hpp>
 #include <ws/parser/token/TokenParser.hpp>
+#include <ws/parser/token/TokenRef.hpp>
+
+int main(int argc, char** argv) {
+    bool trace = argc > 1 && std::string(argv[1]) == "--trace";
+    bool profile = argc > 1 && std::string(argv[1]) == "--profile";
 
-int main() {
     static constexpr std::uintmax_t buffer_size = 4;
     std::string raw_json = ws::module::receive_all(buffer_size);
-    auto json = nlohmann::json::parse(raw_json);
-    auto tokens_res = ws::parser::parse_tokens(json);
+
+    // The contents of the tokens are views into raw_json, it outlives the parse
+    auto tokens_res = ws::parser::parse_tokens_in_place(raw_json);
 
     if (auto err = get_error(tokens_res); err) {
         ws::module::errorln((*err)->what());
@@ -21,12 +29,27 @@ int main() {
 
     auto& tokens = *get_tokens(tokens_res);
 
-    for(auto const& token : tokens) {
-        std::cout << token << '\n';
+    for(std::size_t i = 0; i < tokens.size(); ++i) {
+        std::cout << ws::parser::TokenRef(tokens, i) << '\n';
     }
 
 
-    auto result = ws::parser::parse(tokens);
+    // The stack engine does not recurse, any nesting fails with an error instead of overflowing the stack
+    // Only the combinator engine has the rules to trace, its nesting is limited by a smaller budget
+    ws::parser::ParserContext context;
+    ws::parser::ConsoleTraceSink console;
+    ws::parser::ProfileSink profiler;
+    if (trace)
+        context.set_trace_sink(&console);
+    if (profile)
+        context.set_trace_sink(&profiler);
+
+    auto result = trace || profile 
+        ? ws::parser::ParserEngine().parse(tokens, context) 
+        : ws::parser::StackEngine().parse(tokens, context);
+
+    if (profile)
+        profiler.print_table(std::cout);
 
 
     if (ws::parser::is_error(result)) {
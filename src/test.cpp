@@ -4,37 +4,52 @@
 #include <optional>
 #include <cmath>
 #include <random>
+#include <algorithm>
+#include <sstream>
+#include <array>
+#include <limits>
 
 #include <module/module.h>
+#include <ws/parser/AnyParser.hpp>
 #include <ws/parser/Parser.hpp>
+#include <ws/parser/ParserEngine.hpp>
+#include <ws/parser/StackEngine.hpp>
+#include <ws/parser/ParserInternal.hpp>
+#include <ws/parser/ParserStatic.hpp>
+#include <ws/parser/ParserTrace.hpp>
+#include <ws/parser/ParserProfile.hpp>
+#include <ws/parser/ast/Number.hpp>
 #include <ws/parser/token/Token.hpp>
+#include <ws/parser/token/TokenBuffer.hpp>
+#include <ws/parser/token/TokenParser.hpp>
+#include <ws/parser/token/TokenView.hpp>
 
 ws::parser::Token number(float f) {
-    return {std::to_string(f), ws::parser::TokenType::Literal, ws::parser::TokenSubType::Float};
+    return {std::to_string(f), ws::parser::TokenType::Literal, ws::parser::TokenSubType::Float, 0, 0};
 }
 
 ws::parser::Token plus() {
-    return {"+", ws::parser::TokenType::Operator, ws::parser::TokenSubType::Plus};
+    return {"+", ws::parser::TokenType::Operator, ws::parser::TokenSubType::Plus, 0, 0};
 }
 
 ws::parser::Token mult() {
-    return {"*", ws::parser::TokenType::Operator, ws::parser::TokenSubType::Multiplication};
+    return {"*", ws::parser::TokenType::Operator, ws::parser::TokenSubType::Multiplication, 0, 0};
 }
 
 ws::parser::Token div() {
-    return {"/", ws::parser::TokenType::Operator, ws::parser::TokenSubType::Division};
+    return {"/", ws::parser::TokenType::Operator, ws::parser::TokenSubType::Division, 0, 0};
 }
 
 ws::parser::Token sub() {
-    return {"-", ws::parser::TokenType::Operator, ws::parser::TokenSubType::Minus};
+    return {"-", ws::parser::TokenType::Operator, ws::parser::TokenSubType::Minus, 0, 0};
 }
 
 ws::parser::Token left() {
-    return {"(", ws::parser::TokenType::Parenthesis, ws::parser::TokenSubType::Left};
+    return {"(", ws::parser::TokenType::Parenthesis, ws::parser::TokenSubType::Left, 0, 0};
 }
 
 ws::parser::Token right() {
-    return {")", ws::parser::TokenType::Parenthesis, ws::parser::TokenSubType::Right};
+    return {")", ws::parser::TokenType::Parenthesis, ws::parser::TokenSubType::Right, 0, 0};
 }
 
 std::optional<ws::parser::Token> tokenize(char c) {
@@ -71,35 +86,81 @@ std::optional<ws::parser::Token> tokenize(char c) {
     }    
 }
 
-std::vector<ws::parser::Token> tokenize(std::string const& expr) {
-    std::vector<ws::parser::Token> tokens;
+ws::parser::TokenBuffer tokenize(std::string const& expr) {
+    ws::parser::TokenBuffer tokens;
     for(auto c : expr) {
         auto token = tokenize(c);
         if(token)
-            tokens.emplace_back(*token);
+            tokens.push_back(*token);
     }
 
     return tokens;
 }
 
-bool check(std::vector<ws::parser::Token> const& tokens, bool parsable, bool print_ast) {
-    auto out = ws::parser::parse(tokens);
+// A token given by hand, for the tests that need other contents or positions than 'tokenize'
+struct TokenSpec {
+    std::string_view content;
+    ws::parser::TokenKind kind;
+    std::size_t line;
+    std::size_t column;
+};
+
+ws::parser::TokenBuffer make_tokens(std::vector<TokenSpec> const& specs) {
+    ws::parser::TokenBuffer tokens;
+    for(auto const& spec : specs)
+        tokens.push_back(spec.content, spec.kind, spec.line, spec.column);
+    return tokens;
+}
+
+// Run a parser of either family from the start of the tokens, 'consumed' receives the position of the stream after it
+template<typename P>
+auto run(P const& p, ws::parser::TokenView const& tokens, std::size_t* consumed = nullptr) {
+    ws::parser::TokenStream it(tokens);
+    auto res = p(it);
+    if (consumed)
+        *consumed = it.position();
+    return res;
+}
+
+// Print the name of the test and its status, followed by the detail if there is one
+bool report(std::string const& name, bool test_pass, std::string const& detail = "") {
+    ws::module::print(name, "... ");
+    if (test_pass)
+        ws::module::success("OK");
+    else
+        ws::module::error("ERROR");
+    if (!detail.empty())
+        ws::module::print(": ", detail);
+    ws::module::println();
+    ws::module::println();
+    return test_pass;
+}
+
+ws::parser::ParserContext packrat_context(true);
+
+bool check(ws::parser::TokenBuffer const& tokens, bool parsable, bool print_ast) {
+    static ws::parser::ParserEngine const engine;
+
+    auto out = engine.parse(tokens);
+    auto memoized = engine.parse(tokens, packrat_context);
+    auto stacked = ws::parser::parse(tokens);
 
     ws::module::print("Expression【", std::fixed, std::setprecision(2));
     bool is_first_token = true;
-    for(auto const& t : tokens) {
+    for(std::size_t i = 0; i < tokens.size(); ++i) {
         if (!is_first_token)
             ws::module::print(" ");
-        try {
-             ws::module::print(std::stof(t.content));
-        } catch(...) {
-            ws::module::print(t.content);
-        }
+        if (tokens.kind(i) == ws::parser::TokenKind::LiteralFloat)
+            ws::module::print(tokens.value(i));
+        else
+            ws::module::print(tokens.content(i));
         is_first_token = false;
     }
     ws::module::println("】...");
 
-    bool test_pass = !is_error(out) == parsable;
+    bool test_pass = !is_error(out) == parsable
+        && get_message(out) == get_message(memoized)
+        && get_message(out) == get_message(stacked);
 
     if (test_pass)
         ws::module::success("OK");
@@ -117,12 +178,621 @@ bool check(std::vector<ws::parser::Token> const& tokens, bool parsable, bool pri
     return test_pass;
 }
 
+bool check_trace() {
+    static constexpr std::size_t capacity = 16;
+
+    ws::parser::ParserEngine const engine;
+    ws::parser::ParserContext context;
+    ws::parser::RingTraceSink ring(capacity);
+
+    engine.parse(tokenize("i+i"), context);
+    bool untraced = ring.events().empty();
+
+    context.set_trace_sink(&ring);
+    engine.parse(tokenize("i+i"), context);
+    bool traced = ring.events().size() == (ws::parser::trace_compiled ? capacity : 0);
+
+    bool test_pass = untraced && traced;
+    return report("Trace into a ring buffer", test_pass);
+}
+
+bool check_error(std::string const& expr, std::size_t position, ws::parser::TokenSet expected) {
+    auto out = ws::parser::parse(tokenize(expr));
+    auto error = ws::parser::get_error(out);
+
+    bool test_pass = error && error->position() == position && error->expected_tokens() == expected;
+    return report("Furthest failure of 【" + expr + "】", test_pass, error ? error->what() : "");
+}
+
+bool check_profile() {
+    ws::parser::ParserEngine const engine;
+    ws::parser::ParserContext context;
+    ws::parser::ProfileSink profiler;
+
+    context.set_trace_sink(&profiler);
+    engine.parse(tokenize("i+i"), context);
+
+    auto rules = profiler.rules();
+    auto expr = std::find_if(rules.begin(), rules.end(), [] (ws::parser::RuleProfile const& rule) {
+        return rule.name.rfind("expr :=", 0) == 0;
+    });
+
+    bool test_pass = ws::parser::trace_compiled
+        ? expr != rules.end() && expr->invocations == 1 && expr->successes == 1 && expr->tokens == 3 && expr->cumulative >= expr->self
+        : rules.empty();
+    return report("Profile the rules", test_pass);
+}
+
+bool check_incremental() {
+    ws::parser::StackEngine const engine;
+
+    auto tokens = tokenize("-(i+i)*i/(i-i)+--i");
+    auto expected = get_message(engine.parse(tokens));
+
+    bool test_pass = true;
+    for(std::size_t chunk = 1; chunk <= tokens.size(); ++chunk) {
+        auto parser = engine.incremental();
+        for(std::size_t i = 0; i < tokens.size(); i += chunk)
+            parser.feed(tokens, i, std::min(i + chunk, tokens.size()));
+        test_pass = test_pass && get_message(parser.finish()) == expected;
+    }
+
+    // The error is reported by the chunk with the wrong token, before the end of the stream
+    auto wrong = tokenize("i+)i");
+    auto parser = engine.incremental();
+    test_pass = test_pass 
+        && parser.feed(wrong, 0, 2)
+        && !parser.feed(wrong, 2, 4)
+        && parser.error()->position() == 2;
+
+    // Once finished, nothing more is parsed until a reset
+    auto finished = engine.incremental();
+    finished.feed(tokens);
+    test_pass = test_pass 
+        && get_message(finished.finish()) == expected
+        && !finished.feed(tokens) && is_error(finished.finish());
+    finished.reset();
+    test_pass = test_pass && finished.feed(tokens) && get_message(finished.finish()) == expected;
+
+    return report("Parse chunk by chunk", test_pass);
+}
+
+bool check_slice() {
+    ws::parser::ParserEngine const engine;
+
+    // '(i*i)' in the middle of the batch, parsed in place and from a copy
+    auto batch = tokenize("i+(i*i)-i");
+    ws::parser::TokenBuffer copy;
+    for(std::size_t i = 2; i < 7; ++i)
+        copy.push_back(batch.token(i));
+
+    auto expected = get_message(engine.parse(copy));
+    bool test_pass = !is_error(engine.parse(copy))
+        && get_message(engine.parse(batch, 2, 7)) == expected
+        && get_message(ws::parser::parse(batch, 2, 7)) == expected;
+
+    return report("Parse a slice of the tokens", test_pass);
+}
+
+bool check_operator_table() {
+    using ws::parser::Operator;
+    using ws::parser::TokenType;
+    using ws::parser::TokenSubType;
+
+    // '+' right associative and tighter than '*', '/' postfix
+    ws::parser::OperatorTable table;
+    table.infix(TokenType::Operator, TokenSubType::Plus, 2, Operator::Associativity::Right, "plus")
+         .infix(TokenType::Operator, TokenSubType::Multiplication, 1, Operator::Associativity::Left, "multiplication")
+         .postfix(TokenType::Operator, TokenSubType::Division, 3, "reciprocal");
+    ws::parser::StackEngine const engine(table);
+
+    auto out = engine.parse(tokenize("1+2+3*4/"));
+    auto n = [] (int i) { return std::to_string(static_cast<float>(i)); };
+    auto expected = "((" + n(1) + " + (" + n(2) + " + " + n(3) + ")) * <reciprocal>" + n(4) + ")";
+
+    std::ostringstream dump;
+    if (!is_error(out))
+        dump << **get_ast(out);
+
+    bool test_pass = dump.str() == expected && is_error(engine.parse(tokenize("-1")));
+    return report("Parse with another operator table", test_pass);
+}
+
+bool check_depth() {
+    static constexpr std::size_t depth = 100000;
+
+    std::string expr = std::string(depth, '(') + 'i' + std::string(depth, ')');
+    auto tokens = tokenize(expr);
+
+    auto limited = ws::parser::parse(tokens);
+    auto unlimited = ws::parser::StackEngine(depth).parse(tokens);
+
+    // The recursive engine stops at its own budget, on the same token as the stack engine with that budget
+    static constexpr std::size_t budget = ws::parser::ParserEngine::default_max_depth;
+    auto recursive = ws::parser::ParserEngine().parse(tokens);
+    auto within_budget = tokenize(std::string(budget, '(') + 'i' + std::string(budget, ')'));
+
+    bool test_pass = is_error(limited) && get_error(limited)->kind() == ws::parser::ParserError::Kind::TooDeep 
+        && !is_error(unlimited)
+        && is_error(recursive) && get_error(recursive)->kind() == ws::parser::ParserError::Kind::TooDeep
+        && get_message(recursive) == get_message(ws::parser::StackEngine(budget).parse(tokens))
+        && !is_error(ws::parser::ParserEngine().parse(within_budget));
+    return report("Parse " + std::to_string(depth) + " nested parenthesis without recursion", test_pass);
+}
+
+bool check_commit() {
+    using ws::parser::TokenType;
+    using ws::parser::TokenSubType;
+
+    std::size_t runs = 0;
+    auto left = ws::parser::eat(TokenType::Parenthesis, TokenSubType::Left);
+    auto number = ws::parser::map([&runs] (ws::parser::TokenRef t) { ++runs; return t; }, 
+        ws::parser::eat(TokenType::Literal, TokenSubType::Float));
+
+    // '((' then '(1', the first alternative fails on '1'
+    auto backtracking = (left > left) | (left > number);
+    auto committed = (left > ws::parser::commit(left)) | (left > number);
+
+    auto tokens = tokenize("(1");
+    bool test_pass = !ws::parser::has_failed(run(backtracking, tokens)) && runs == 1
+        && ws::parser::is_committed(run(committed, tokens)) && runs == 1;
+
+    // Only '(' ')' can start with '(', it is the one run, its failure leaves the stream where it was like a backtrack
+    namespace ct = ws::parser::ct;
+    auto predicted = (ct::eat(TokenType::Parenthesis, TokenSubType::Left) & ct::eat(TokenType::Parenthesis, TokenSubType::Right))
+        | ct::eat(TokenType::Literal, TokenSubType::Float);
+    std::size_t consumed = 1;
+    test_pass = test_pass && ws::parser::has_failed(run(predicted, tokens, &consumed)) && consumed == 0;
+    return report("Commit stops the backtracking", test_pass);
+}
+
+bool check_chain() {
+    namespace ct = ws::parser::ct;
+
+    auto number = ct::map([] (ws::parser::TokenRef t) { return static_cast<float>(t.value()); },
+        ct::eat(ws::parser::TokenType::Literal, ws::parser::TokenSubType::Float));
+    auto minus = ct::eat(ws::parser::TokenType::Operator, ws::parser::TokenSubType::Minus);
+    auto subtract = [] (float lhs, ws::parser::TokenRef, float rhs) { return lhs - rhs; };
+
+    auto tokens = tokenize("1-2-3");
+    std::size_t left_consumed = 0, right_consumed = 0;
+    auto left = run(ct::chainl1(number, minus, subtract), tokens, &left_consumed);
+    auto right = run(ct::chainr1(number, minus, subtract), tokens, &right_consumed);
+
+    bool test_pass = !ws::parser::has_failed(left) && std::get<float>(left) == -4.f
+        && !ws::parser::has_failed(right) && std::get<float>(right) == 2.f
+        && left_consumed == tokens.size() && right_consumed == tokens.size();
+    return report("Fold 1-2-3 left and right associated", test_pass);
+}
+
+bool check_any_parser() {
+    namespace ct = ws::parser::ct;
+
+    auto number = ct::eat(ws::parser::TokenType::Literal, ws::parser::TokenSubType::Float);
+    auto big = [number, padding = std::array<char, 256>{}] (ws::parser::TokenStream& it) { return number(it); };
+
+    // Small parsers are stored inline, copies and moves keep them usable
+    ws::parser::AnyParser<ws::parser::TokenRef> small(number);
+    ws::parser::AnyParser<ws::parser::TokenRef> heap(big);
+    auto copy = small;
+    auto moved = std::move(heap);
+
+    auto tokens = tokenize("i");
+    auto parse = [&] (ws::parser::AnyParser<ws::parser::TokenRef> const& p) {
+        std::size_t consumed = 0;
+        return !ws::parser::has_failed(run(p, tokens, &consumed)) && consumed == tokens.size();
+    };
+
+    bool test_pass = small.is_inline() && copy.is_inline() && !moved.is_inline() && !heap
+        && parse(small) && parse(copy) && parse(moved);
+    return report("Type erased parsers stored inline or allocated", test_pass);
+}
+
+bool check_lookahead() {
+    namespace ct = ws::parser::ct;
+    using ws::parser::TokenSet;
+    using ws::parser::TokenType;
+    using ws::parser::TokenSubType;
+
+    auto right_par = ct::eat(TokenType::Parenthesis, TokenSubType::Right);
+    auto plus = TokenSet::of(TokenType::Operator, TokenSubType::Plus);
+
+    // Succeed or fail without consuming anything
+    auto succeeds = [] (auto const& p, std::string const& expr) {
+        std::size_t consumed = 0;
+        return !ws::parser::has_failed(run(p, tokenize(expr), &consumed)) && consumed == 0;
+    };
+
+    auto error = run(ct::lookahead(2, plus), tokenize("i("));
+
+    bool test_pass = succeeds(ct::peek(right_par), ")") && !succeeds(ct::peek(right_par), "i")
+        && succeeds(ct::not_(right_par), "i") && !succeeds(ct::not_(right_par), ")")
+        && succeeds(ct::peek(right_par & right_par), "))") && !succeeds(ct::not_(right_par & right_par), "))")
+        && succeeds(ct::lookahead(2, plus), "i+i") && !succeeds(ct::lookahead(3, plus), "i+")
+        && ws::parser::has_failed(error) && std::get<ws::parser::ParserError>(error).position() == 1
+        && succeeds(ws::parser::peek(ws::parser::eat(TokenType::Parenthesis, TokenSubType::Right)), ")")
+        && succeeds(ws::parser::not_(ws::parser::eat(TokenType::Parenthesis, TokenSubType::Right)), "i")
+        && succeeds(ws::parser::lookahead(1, TokenSet::end_of_stream()), "");
+
+    // What a probe tries is not required: only a failed peek is recorded as the furthest failure
+    auto expected_after = [] (auto const& p, std::string const& expr) {
+        auto tokens = tokenize(expr);
+        ws::parser::ParserContext context;
+        context.begin_parse();
+        ws::parser::TokenStream it(tokens, &context);
+        p(it);
+        return context.furthest_failure().expected_tokens();
+    };
+    auto left_par = ct::eat(TokenType::Parenthesis, TokenSubType::Left);
+    auto pair = ws::parser::eat(TokenType::Parenthesis, TokenSubType::Left) & ws::parser::eat(TokenType::Parenthesis, TokenSubType::Right);
+    test_pass = test_pass
+        && expected_after(ct::not_(left_par & right_par), "(i") == TokenSet()
+        && expected_after(ct::peek(left_par & right_par), "(i") == left_par.first()
+        && expected_after(ws::parser::not_(pair), "(i") == TokenSet()
+        && expected_after(ws::parser::peek(pair), "(i") == right_par.first();
+
+    // They never consume: they are nullable, and a loop over one of them stops after an iteration
+    auto loops_once = [] (auto const& p) {
+        std::size_t consumed = 0;
+        auto res = run(p, tokenize(")"), &consumed);
+        return !ws::parser::has_failed(res) && std::get<1>(res).size() == 1 && consumed == 0;
+    };
+    test_pass = test_pass
+        && ct::peek(right_par).nullable() && ct::lookahead(1, plus).nullable()
+        && ct::not_(right_par).nullable() && ct::not_(right_par).first() == TokenSet::all()
+        && loops_once(ct::many(ct::peek(right_par)))
+        && loops_once(ws::parser::many(ws::parser::peek(ws::parser::eat(TokenType::Parenthesis, TokenSubType::Right))));
+    return report("Look ahead without consuming", test_pass);
+}
+
+bool check_in_place() {
+    static std::string const inputs[] = {
+        R"([{"content": "1.5", "type": "literal.float", "line": 1, "column": 1}, {"type": "operator.plus", "content": "+", "column": 5, "line": 1, "extra": ["\"", {}]}])",
+        R"([{"content": "1\u0035", "type": "literal.float", "line": 2, "column": 3}])",
+        R"([{"content": "(", "type": "parenthesis", "line": 1, "column": 1}])",
+        R"([{"content": "(", "type": "operator.modulo", "line": 1, "column": 1}])",
+        R"([{"content": "(", "type": "", "line": 1, "column": 1}])",
+        R"([{"content": 1, "type": "literal.float", "line": 1, "column": 1}])",
+        R"([{"content": "1", "type": "literal.float", "line": -1, "column": 1}])",
+        R"([{"content": "1", "type": "literal.float", "line": 1.5, "column": 1}])",
+        R"([{"content": "1", "type": "literal.float", "line": 1}])",
+        R"([{"content": "1.2.3", "type": "literal.float", "line": 4, "column": 2}])",
+        R"([[]])",
+        R"({})",
+        R"([])"
+    };
+
+    auto describe = [] (ws::parser::TokenParserResult const& res) {
+        std::ostringstream os;
+        if (auto err = ws::parser::get_error(res); err)
+            return (*err)->what();
+        auto const& tokens = *ws::parser::get_tokens(res);
+        for(std::size_t i = 0; i < tokens.size(); ++i)
+            os << ws::parser::TokenRef(tokens, i);
+        return os.str();
+    };
+
+    // Same tokens and errors as from the JSON document
+    bool test_pass = true;
+    for(auto const& input : inputs) {
+        std::ostringstream silent;
+        auto cout = std::cout.rdbuf(silent.rdbuf());
+        auto expected = describe(ws::parser::parse_tokens(nlohmann::json::parse(input)));
+        std::cout.rdbuf(cout);
+        test_pass = test_pass && describe(ws::parser::parse_tokens_in_place(input)) == expected;
+    }
+
+    // The contents without escape sequence are in the input
+    auto in_input = [] (std::string const& input, std::string_view content) {
+        return content.data() >= input.data() && content.data() < input.data() + input.size();
+    };
+    auto viewed = ws::parser::parse_tokens_in_place(inputs[0]);
+    auto escaped = ws::parser::parse_tokens_in_place(inputs[1]);
+    test_pass = test_pass 
+        && in_input(inputs[0], ws::parser::get_tokens(viewed)->content(0)) 
+        && in_input(inputs[0], ws::parser::get_tokens(viewed)->content(1))
+        && ws::parser::get_tokens(escaped)->content(0) == "15" 
+        && !in_input(inputs[1], ws::parser::get_tokens(escaped)->content(0))
+        && ws::parser::is_error(ws::parser::parse_tokens_in_place("[{\"content\": "));
+
+    return report("Read the tokens in place", test_pass);
+}
+
+bool check_token_kind() {
+    using ws::parser::TokenKind;
+    using ws::parser::TokenSet;
+    using ws::parser::TokenType;
+    using ws::parser::TokenSubType;
+
+    static constexpr std::pair<TokenType, TokenSubType> pairs[] = {
+        {TokenType::Parenthesis, TokenSubType::Left}, {TokenType::Parenthesis, TokenSubType::Right},
+        {TokenType::Operator, TokenSubType::Plus}, {TokenType::Operator, TokenSubType::Minus},
+        {TokenType::Operator, TokenSubType::Multiplication}, {TokenType::Operator, TokenSubType::Division},
+        {TokenType::Literal, TokenSubType::Float}
+    };
+
+    // Every pair has its own kind, that gives the pair back
+    bool test_pass = std::size(pairs) == ws::parser::token_kind_count;
+    TokenSet seen;
+    for(auto [type, subtype] : pairs) {
+        auto kind = ws::parser::kind_of(type, subtype);
+        test_pass = test_pass 
+            && ws::parser::type_of(kind) == type && ws::parser::subtype_of(kind) == subtype
+            && !seen.intersects(TokenSet::of(kind));
+        seen = seen | TokenSet::of(kind);
+    }
+
+    // No other pair is a kind
+    for(auto [type, subtype] : pairs)
+        for(auto other : {TokenType::Parenthesis, TokenType::Operator, TokenType::Literal})
+            test_pass = test_pass && ws::parser::is_subtype_of(subtype, other) == (other == type);
+
+    // The buffer stores the kind, the parsers match on it
+    auto tokens = tokenize("i+i");
+    std::size_t consumed = 0;
+    auto eaten = run(ws::parser::ct::eat(TokenKind::LiteralFloat), tokens, &consumed);
+    std::ostringstream os;
+    os << tokens.token(1);
+    test_pass = test_pass 
+        && tokens.kind(1) == TokenKind::OperatorPlus
+        && tokens.token(1).type() == TokenType::Operator
+        && !ws::parser::has_failed(eaten) && consumed == 1
+        && os.str() == "{+ : operator.plus at 0:0}";
+
+    return report("Pack the token kinds", test_pass);
+}
+
+bool check_numeral() {
+    using ws::parser::TokenKind;
+
+    // Read once at ingest, whole content only, finite values only
+    auto value = [] (std::string const& content) { return ws::parser::read_float(content); };
+    bool test_pass = value("1.5") == 1.5 && value("-12.34") == -12.34 && value("15") == 15. && value("2e3") == 2000.
+        && !value("") && !value("1.2.3") && !value("1,5") && !value(" 1") && !value("1e999") && !value("nan") && !value("inf");
+
+    // Too small for a double is 0 with its sign, not an error, the subnormals are kept, too large is an error
+    auto is_zero = [&] (std::string const& content, bool negative) {
+        auto read = value(content);
+        return read && *read == 0. && std::signbit(*read) == negative;
+    };
+    test_pass = test_pass
+        && is_zero("1e-400", false) && is_zero("-1e-400", true) && is_zero("0.0000001e-320", false) && is_zero("1e-100000000000000000000", false)
+        && value("4.9e-324") > 0. && value("1e-310") == 1e-310
+        && !value("1000e306") && !value("0.001e312") && !value("-1e100000000000000000000") && !value("1e-400x");
+
+    // Malformed numerals are rejected with their position, from the document and in place
+    auto input = R"([{"content": "1.5", "type": "literal.float", "line": 1, "column": 1}, {"content": "1..5", "type": "literal.float", "line": 1, "column": 7}])";
+    std::ostringstream silent;
+    auto cout = std::cout.rdbuf(silent.rdbuf());
+    auto from_document = ws::parser::parse_tokens(nlohmann::json::parse(input));
+    std::cout.rdbuf(cout);
+    auto in_place = ws::parser::parse_tokens_in_place(input);
+    std::string const message = "Float literal '1..5' at 1:7 is not a numeral";
+    test_pass = test_pass 
+        && ws::parser::is_error(from_document) && (*ws::parser::get_error(from_document))->what() == message
+        && ws::parser::is_error(in_place) && (*ws::parser::get_error(in_place))->what() == message;
+
+    // A token or a buffer never holds an invalid value
+    ws::parser::Token invalid("1..5", TokenKind::LiteralFloat, 1, 7);
+    ws::parser::TokenBuffer refused;
+    test_pass = test_pass 
+        && !invalid.value && !refused.push_back(invalid) && !refused.push_back("1e999", TokenKind::LiteralFloat, 1, 1)
+        && refused.push_back("1e-400", TokenKind::LiteralFloat, 1, 1) && refused.size() == 1 && refused.value(0) == 0.;
+
+    // The value goes from the token to the Number node, the other kinds have none
+    auto tokens = make_tokens({
+        {"(", TokenKind::ParenthesisLeft, 0, 0}, {"0.25", TokenKind::LiteralFloat, 0, 1}, {")", TokenKind::ParenthesisRight, 0, 5}
+    });
+    auto out = ws::parser::parse(tokens);
+    auto const* number = ws::parser::is_error(out) ? nullptr : dynamic_cast<ws::parser::Number const*>(ws::parser::get_ast(out)->get());
+    test_pass = test_pass 
+        && tokens.value(0) == 0 && tokens.value(1) == 0.25
+        && number && number->value() == 0.25;
+
+    return report("Read the numerals at ingest", test_pass);
+}
+
+bool check_positions() {
+    using ws::parser::TokenKind;
+
+    // Lines skipped, revisited, columns out of order: every position is given back as pushed
+    std::vector<TokenSpec> specs;
+    for(auto [line, column] : {std::pair<std::size_t, std::size_t>
+        {1, 1}, {1, 3}, {1, 2}, {4, 10}, {4, 0}, {2, 7}, {4, 1}, {4000000000, 4}, {0, 0}})
+        specs.push_back({"(", TokenKind::ParenthesisLeft, line, column});
+    auto tokens = make_tokens(specs);
+
+    bool test_pass = true;
+    for(std::size_t i = 0; i < tokens.size(); ++i)
+        test_pass = test_pass && tokens.line(i) == specs[i].line && tokens.column(i) == specs[i].column;
+
+    // From the JSON ingest, the tokens and the errors print 'line:column' as given
+    auto input = R"([{"content": "1", "type": "literal.float", "line": 3, "column": 5}, {"content": "+", "type": "operator.plus", "line": 3, "column": 7}, {"content": "(", "type": "parenthesis.left", "line": 8, "column": 1}])";
+    auto res = ws::parser::parse_tokens_in_place(input);
+    auto const& read = *ws::parser::get_tokens(res);
+    std::ostringstream os;
+    os << ws::parser::TokenRef(read, 2) << read.token(0);
+    auto out = ws::parser::parse(read);
+    test_pass = test_pass 
+        && os.str() == "{( : parenthesis.left at 8:1}{1 : literal.float at 3:5}"
+        && ws::parser::is_error(out) && ws::parser::get_error(out)->line() == 8 && ws::parser::get_error(out)->column() == 2;
+
+    // The lines past 32 bits, and the offsets whose next one would wrap, are refused instead of aliasing other positions
+    std::size_t const max = std::numeric_limits<std::uint32_t>::max();
+    ws::parser::TokenBuffer lines, columns;
+    test_pass = test_pass
+        && !lines.push_back("(", TokenKind::ParenthesisLeft, max + 1, 0)
+        && lines.push_back("(", TokenKind::ParenthesisLeft, max, 0)
+        && lines.size() == 1 && lines.line(0) == max
+        && !columns.push_back("(", TokenKind::ParenthesisLeft, 1, max)
+        && columns.push_back("(", TokenKind::ParenthesisLeft, 1, max - 1)
+        && columns.push_back("(", TokenKind::ParenthesisLeft, 1, 5)
+        && !columns.is_reachable(2, 0) && !columns.push_back("(", TokenKind::ParenthesisLeft, 2, 0)
+        && columns.size() == 2 && columns.column(0) == max - 1 && columns.line(1) == 1 && columns.column(1) == 5;
+
+    // The ingest fails on them, from the document and in place
+    auto fails_at = [] (std::string const& input, std::string const& position) {
+        std::ostringstream silent;
+        auto cout = std::cout.rdbuf(silent.rdbuf());
+        auto from_document = ws::parser::parse_tokens(nlohmann::json::parse(input));
+        std::cout.rdbuf(cout);
+        auto in_place = ws::parser::parse_tokens_in_place(input);
+        std::string const message = "Position " + position + " of the token is past the 32 bits offsets of the token buffer";
+        return ws::parser::is_error(from_document) && (*ws::parser::get_error(from_document))->what() == message
+            && ws::parser::is_error(in_place) && (*ws::parser::get_error(in_place))->what() == message;
+    };
+    test_pass = test_pass
+        && fails_at(R"([{"content": "(", "type": "parenthesis.left", "line": 4294967296, "column": 1}])", "4294967296:1")
+        && fails_at(R"([{"content": "(", "type": "parenthesis.left", "line": 1, "column": 4294967294}, {"content": "(", "type": "parenthesis.left", "line": 2, "column": 0}])", "2:0");
+
+    return report("Resolve the positions from the offsets", test_pass);
+}
+
+bool check_memo() {
+    namespace ct = ws::parser::ct;
+    using ws::parser::TokenKind;
+    using ws::parser::AST_ptr;
+
+    // Both alternatives start with 'x' at the same position, the second one reuses the result of the first one
+    std::size_t runs = 0;
+    auto x = ct::memo(ct::map([&runs] (ws::parser::TokenRef t) -> AST_ptr {
+        ++runs;
+        return std::make_unique<ws::parser::Number>(std::string(t.content()), t.value());
+    }, ct::eat(TokenKind::LiteralFloat)));
+    auto grammar = (x & ct::eat(TokenKind::OperatorPlus)) | (x & ct::eat(TokenKind::OperatorMinus));
+
+    auto describe = [] (auto const& res) {
+        if (ws::parser::has_failed(res))
+            return std::string("error");
+        // The alternative that matched, then the number and the operator
+        std::ostringstream os;
+        os << std::get<1>(res).index() << ' ';
+        std::visit([&os] (auto const& tuple) { os << *std::get<0>(tuple) << ' ' << std::get<1>(tuple).content(); }, std::get<1>(res));
+        return os.str();
+    };
+
+    auto tokens = tokenize("1-");
+    ws::parser::ParserContext context(true);
+    context.begin_parse();
+    ws::parser::TokenStream it(tokens, &context);
+    auto memoized = describe(grammar(it));
+    auto memoized_runs = runs;
+
+    runs = 0;
+    auto unmemoized = describe(run(grammar, tokens));
+
+    bool test_pass = memoized != "error" && memoized == unmemoized
+        && context.memo_hits() == 1 && context.memo_misses() == 1
+        && memoized_runs == 1 && runs == 2;
+    return report("Reuse a memoized rule when backtracking", test_pass);
+}
+
+bool check_token_view() {
+    using ws::parser::TokenKind;
+    using ws::parser::TokenView;
+
+    // '(1+2)*3' in columns owned by the caller, the contents in the source: parsed in place, nothing is copied
+    std::string_view source = "(1+2)*3";
+    TokenKind const kinds[] = {TokenKind::ParenthesisLeft, TokenKind::LiteralFloat, TokenKind::OperatorPlus, 
+        TokenKind::LiteralFloat, TokenKind::ParenthesisRight, TokenKind::OperatorMultiplication, TokenKind::LiteralFloat};
+    TokenView::Span contents[7];
+    std::uint32_t offsets[7];
+    for(std::uint32_t i = 0; i < 7; ++i) {
+        contents[i] = {i | TokenView::in_source, 1};
+        offsets[i] = i;
+    }
+    TokenView::LineStart const line_starts[] = {{0, 1}};
+    TokenView view({7, kinds, contents, offsets, line_starts, 1, nullptr, source});
+
+    std::vector<TokenSpec> specs;
+    for(std::size_t i = 0; i < source.size(); ++i)
+        specs.push_back({source.substr(i, 1), kinds[i], 1, i});
+    auto expected = make_tokens(specs);
+    auto dump = [] (ws::parser::ParserResult const& res) {
+        return is_error(res) ? get_message(res) : (*get_ast(res))->compile().dump();
+    };
+    auto const reference = dump(ws::parser::parse(expected));
+    bool test_pass = !is_error(ws::parser::parse(view))
+        && dump(ws::parser::parse(view)) == reference
+        && dump(ws::parser::ParserEngine().parse(view)) == reference
+        && dump(ws::parser::StackEngine().parse(view, 1, 4)) == dump(ws::parser::parse(expected, 1, 4))
+        && view.content(5).data() == source.data() + 5
+        && view.line(6) == 1 && view.column(6) == 6;
+
+    // The line starts must increase from offset 0, or a position would be before the first line
+    TokenView::LineStart const late[] = {{3, 1}};
+    TokenView::LineStart const unordered[] = {{0, 1}, {4, 2}, {4, 3}};
+    test_pass = test_pass
+        && TokenView::has_valid_line_starts({7, kinds, contents, offsets, line_starts, 1, nullptr, source})
+        && TokenView::has_valid_line_starts({})
+        && !TokenView::has_valid_line_starts({7, kinds, contents, offsets, nullptr, 0, nullptr, source})
+        && !TokenView::has_valid_line_starts({7, kinds, contents, offsets, late, 1, nullptr, source})
+        && !TokenView::has_valid_line_starts({7, kinds, contents, offsets, unordered, 3, nullptr, source});
+
+    // An error is located in the view like in a buffer
+    TokenView truncated({2, kinds, contents, offsets, line_starts, 1, nullptr, source});
+    auto error = ws::parser::parse(truncated);
+    test_pass = test_pass && is_error(error) && get_error(error)->line() == 1 && get_error(error)->column() == 2;
+
+    // A buffer copied or moved is the view of its own columns, the small pool of the original is gone
+    auto copied = [] {
+        auto original = make_tokens({{"(", TokenKind::ParenthesisLeft, 1, 0}, {"1", TokenKind::LiteralFloat, 1, 1}, {")", TokenKind::ParenthesisRight, 1, 2}});
+        ws::parser::TokenBuffer copy(original);
+        return copy;
+    }();
+    ws::parser::TokenBuffer moved;
+    moved = make_tokens(specs);
+    test_pass = test_pass 
+        && copied.content(1) == "1" && !is_error(ws::parser::parse(copied))
+        && dump(ws::parser::parse(moved)) == reference;
+
+    return report("Parse the columns of the caller through a view", test_pass);
+}
+
+bool check_buffer_limits() {
+    using ws::parser::TokenKind;
+    using ws::parser::TokenView;
+
+    // The views must be in the source
+    std::string_view source = "(1)";
+    ws::parser::TokenBuffer tokens(source);
+    bool test_pass = tokens.push_back_view(0, 1, TokenKind::ParenthesisLeft, 1, 0)
+        && !tokens.push_back_view(2, 5, TokenKind::LiteralFloat, 1, 1)
+        && !tokens.push_back_view(4, 0, TokenKind::LiteralFloat, 1, 1)
+        && tokens.size() == 1;
+
+    // Past 2 GiB a view or a copy would alias another content, the limits are checked from the sizes
+    using ws::parser::TokenBuffer;
+    std::size_t const limit = TokenView::in_source;
+    std::size_t const max = std::numeric_limits<std::uint32_t>::max();
+    test_pass = test_pass
+        && TokenBuffer::fits_in_pool(0, limit - 1) && !TokenBuffer::fits_in_pool(0, limit)
+        && TokenBuffer::fits_in_pool(limit - 2, 1) && !TokenBuffer::fits_in_pool(limit - 1, 1) && !TokenBuffer::fits_in_pool(limit, 0)
+        && TokenBuffer::fits_in_source(3, 1, 2) && !TokenBuffer::fits_in_source(3, 2, 5) && !TokenBuffer::fits_in_source(3, 4, 0)
+        && TokenBuffer::fits_in_source(limit + 2, limit - 1, 3) && !TokenBuffer::fits_in_source(limit + 2, limit, 1)
+        && TokenBuffer::fits_in_source(max + 1, 0, max) && !TokenBuffer::fits_in_source(max + 2, 0, max + 1);
+
+    return report("Refuse the contents past the limits of the buffer", test_pass);
+}
+
 int main(int argc, char** argv) {
     bool print_ast = argc > 1 && std::string(argv[1]) == "--ast";
 
 #define CHECK_T(is...) check(tokenize(is), true, print_ast)
 #define CHECK_F(is...) check(tokenize(is), false, print_ast)
 
+    using ws::parser::TokenSet;
+    using ws::parser::TokenType;
+    using ws::parser::TokenSubType;
+
+    auto operand = TokenSet::of(TokenType::Operator, TokenSubType::Minus) 
+        | TokenSet::of(TokenType::Literal, TokenSubType::Float) 
+        | TokenSet::of(TokenType::Parenthesis, TokenSubType::Left);
+    auto operators = TokenSet::of(TokenType::Operator, TokenSubType::Plus) 
+        | TokenSet::of(TokenType::Operator, TokenSubType::Minus) 
+        | TokenSet::of(TokenType::Operator, TokenSubType::Multiplication) 
+        | TokenSet::of(TokenType::Operator, TokenSubType::Division);
+
     bool all_test =
        CHECK_F("")
     && CHECK_T("i")
@@ -152,7 +822,27 @@ int main(int argc, char** argv) {
     && CHECK_T("i/i+i/i")
     && CHECK_F("+i+i")
     && CHECK_F("i+/i")
-    && CHECK_T("i+i+i+--i*--i");
+    && CHECK_T("i+i+i+--i*--i")
+    && check_error("i+/i", 2, operand)
+    && check_error("(i", 2, operators | TokenSet::of(TokenType::Parenthesis, TokenSubType::Right))
+    && check_error("i(", 1, operators | TokenSet::end_of_stream())
+    && check_slice()
+    && check_operator_table()
+    && check_depth()
+    && check_incremental()
+    && check_trace()
+    && check_profile()
+    && check_chain()
+    && check_commit()
+    && check_any_parser()
+    && check_lookahead()
+    && check_in_place()
+    && check_token_kind()
+    && check_numeral()
+    && check_positions()
+    && check_memo()
+    && check_token_view()
+    && check_buffer_limits();
 
     if (all_test)
         ws::module::successln("Pass all tests");
@@ -0,0 +1,196 @@
+#include <ws/parser/IncrementalParser.hpp>
+
+#include <ws/parser/ast/AST.hpp>
+#include <ws/parser/ast/Number.hpp>
+#include <ws/parser/ast/BinaryOperator.hpp>
+#include <ws/parser/ast/UnaryOperator.hpp>
+
+namespace ws::parser {
+
+namespace {
+
+constexpr TokenSet float_token = TokenSet::of(TokenType::Literal, TokenSubType::Float);
+constexpr TokenSet left_parenthesis = TokenSet::of(TokenType::Parenthesis, TokenSubType::Left);
+constexpr TokenSet right_parenthesis = TokenSet::of(TokenType::Parenthesis, TokenSubType::Right);
+
+std::shared_ptr<OperatorTable const> const& calculator_table() {
+    static auto const table = std::make_shared<OperatorTable const>(OperatorTable::calculator());
+    return table;
+}
+
+}
+
+IncrementalParser::IncrementalParser(std::size_t max_depth) : IncrementalParser(calculator_table(), max_depth) {}
+
+IncrementalParser::IncrementalParser(std::shared_ptr<OperatorTable const> table, std::size_t max_depth) 
+    : table(std::move(table)), depth_budget(max_depth) {}
+
+IncrementalParser::~IncrementalParser() = default;
+
+IncrementalParser::IncrementalParser(IncrementalParser&&) noexcept = default;
+
+IncrementalParser& IncrementalParser::operator=(IncrementalParser&&) noexcept = default;
+
+bool IncrementalParser::feed(TokenView const& tokens) {
+    return feed(tokens, 0, tokens.size());
+}
+
+bool IncrementalParser::feed(TokenView const& tokens, std::size_t begin, std::size_t end) {
+    if (state == State::Finished)
+        return false;
+
+    for(std::size_t i = begin; i < end && state != State::Failed; ++i) {
+        step(tokens, i);
+        ++consumed;
+    }
+
+    if (end > begin) {
+        end_line = tokens.line(end - 1);
+        end_column = tokens.column(end - 1) + tokens.content(end - 1).size();
+    }
+    return state != State::Failed;
+}
+
+ParserResult IncrementalParser::finish() {
+    if (state == State::Failed)
+        return *failure;
+
+    // The AST was already given, there is nothing left to return
+    if (state == State::Finished)
+        return at_end(ParserError::error(consumed));
+
+    if (state == State::Operand) {
+        fail(at_end(ParserError::expected(table->prefixes() | float_token | left_parenthesis, consumed)));
+        return *failure;
+    }
+
+    if (groups > 0) {
+        fail(at_end(ParserError::expected(after_operand(), consumed)));
+        return *failure;
+    }
+
+    while(!frames.empty())
+        reduce();
+
+    state = State::Finished;
+    return std::move(operands.back());
+}
+
+void IncrementalParser::reset() {
+    frames.clear();
+    operands.clear();
+    state = State::Operand;
+    failure.reset();
+    consumed = 0;
+    nesting = 0;
+    groups = 0;
+    end_line = 1;
+    end_column = 1;
+}
+
+bool IncrementalParser::has_failed() const {
+    return state == State::Failed;
+}
+
+ParserError const* IncrementalParser::error() const {
+    return failure ? &*failure : nullptr;
+}
+
+std::size_t IncrementalParser::position() const {
+    return consumed;
+}
+
+void IncrementalParser::step(TokenView const& tokens, std::size_t index) {
+    auto kind = TokenSet::of(tokens.kind(index));
+
+    // An operand is expected: a prefix operator, a float or '('
+
+    if (state == State::Operand) {
+        auto op = table->prefix_of(tokens.kind(index));
+        if (op || left_parenthesis.intersects(kind)) {
+            if (nesting >= depth_budget)
+                return fail(ParserError::too_deep(consumed).at(tokens.line(index), tokens.column(index)));
+            frames.push_back({op});
+            ++nesting;
+            groups += op ? 0 : 1;
+            return;
+        }
+
+        if (!float_token.intersects(kind))
+            return fail(ParserError::expected(table->prefixes() | float_token | left_parenthesis, consumed).at(tokens.line(index), tokens.column(index)));
+
+        operands.emplace_back(std::make_unique<Number>(std::string(tokens.content(index)), tokens.value(index)));
+        state = State::Operator;
+        return;
+    }
+
+    if (state != State::Operator)
+        return;
+
+    // An infix or postfix operator is expected, or the end of a group
+
+    if (auto op = table->infix_or_postfix_of(tokens.kind(index)); op) {
+        reduce_before(*op);
+        if (op->fixity == Operator::Fixity::Postfix) {
+            operands.back() = std::make_unique<UnaryOperator>(op->name, std::move(operands.back()));
+            return;
+        }
+        frames.push_back({op});
+        state = State::Operand;
+        return;
+    }
+
+    if (groups > 0 && right_parenthesis.intersects(kind)) {
+        while(frames.back().op)
+            reduce();
+        frames.pop_back();
+        --nesting;
+        --groups;
+        return;
+    }
+
+    fail(ParserError::expected(after_operand(), consumed).at(tokens.line(index), tokens.column(index)));
+}
+
+// Replace the operator on top of the stack and its operands by their AST
+
+void IncrementalParser::reduce() {
+    auto op = frames.back().op;
+    frames.pop_back();
+
+    auto rhs = std::move(operands.back());
+    if (op->fixity == Operator::Fixity::Prefix) {
+        --nesting;
+        operands.back() = std::make_unique<UnaryOperator>(op->name, std::move(rhs));
+        return;
+    }
+
+    operands.pop_back();
+    operands.back() = std::make_unique<BinaryOperator>(op->name, std::move(operands.back()), std::move(rhs));
+}
+
+// Reduce the pending operators of the group binding tighter than 'op'
+
+void IncrementalParser::reduce_before(Operator const& op) {
+    while(!frames.empty() && frames.back().op) {
+        auto const& top = *frames.back().op;
+        if (top.precedence < op.precedence || (top.precedence == op.precedence && op.associativity == Operator::Associativity::Right))
+            return;
+        reduce();
+    }
+}
+
+void IncrementalParser::fail(ParserError const& error) {
+    failure = error;
+    state = State::Failed;
+}
+
+ParserError IncrementalParser::at_end(ParserError const& error) const {
+    return error.at(end_line, end_column);
+}
+
+TokenSet IncrementalParser::after_operand() const {
+    return table->infixes_and_postfixes() | (groups > 0 ? right_parenthesis : TokenSet::end_of_stream());
+}
+
+}
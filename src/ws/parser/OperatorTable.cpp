@@ -0,0 +1,51 @@
+#include <ws/parser/OperatorTable.hpp>
+
+namespace ws::parser {
+
+OperatorTable& OperatorTable::prefix(TokenType type, TokenSubType subtype, unsigned precedence, std::string const& name) {
+    prefix_operators[index_of(kind_of(type, subtype))] = Operator{Operator::Fixity::Prefix, precedence, Operator::Associativity::Right, name};
+    prefix_set = prefix_set | TokenSet::of(type, subtype);
+    return *this;
+}
+
+OperatorTable& OperatorTable::infix(TokenType type, TokenSubType subtype, unsigned precedence, Operator::Associativity associativity, std::string const& name) {
+    other_operators[index_of(kind_of(type, subtype))] = Operator{Operator::Fixity::Infix, precedence, associativity, name};
+    other_set = other_set | TokenSet::of(type, subtype);
+    return *this;
+}
+
+OperatorTable& OperatorTable::postfix(TokenType type, TokenSubType subtype, unsigned precedence, std::string const& name) {
+    other_operators[index_of(kind_of(type, subtype))] = Operator{Operator::Fixity::Postfix, precedence, Operator::Associativity::Left, name};
+    other_set = other_set | TokenSet::of(type, subtype);
+    return *this;
+}
+
+OperatorTable OperatorTable::calculator() {
+    OperatorTable table;
+    table.infix(TokenType::Operator, TokenSubType::Plus, 1, Operator::Associativity::Left, "plus")
+         .infix(TokenType::Operator, TokenSubType::Minus, 1, Operator::Associativity::Left, "subtract")
+         .infix(TokenType::Operator, TokenSubType::Multiplication, 2, Operator::Associativity::Left, "multiplication")
+         .infix(TokenType::Operator, TokenSubType::Division, 2, Operator::Associativity::Left, "division")
+         .prefix(TokenType::Operator, TokenSubType::Minus, 3, "negate");
+    return table;
+}
+
+Operator const* OperatorTable::prefix_of(TokenKind kind) const {
+    auto& op = prefix_operators[index_of(kind)];
+    return op ? &*op : nullptr;
+}
+
+Operator const* OperatorTable::infix_or_postfix_of(TokenKind kind) const {
+    auto& op = other_operators[index_of(kind)];
+    return op ? &*op : nullptr;
+}
+
+TokenSet OperatorTable::prefixes() const {
+    return prefix_set;
+}
+
+TokenSet OperatorTable::infixes_and_postfixes() const {
+    return other_set;
+}
+
+}
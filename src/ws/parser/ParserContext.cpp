@@ -0,0 +1,90 @@
+#include <ws/parser/ParserContext.hpp>
+
+namespace ws::parser {
+
+ParserContext::ParserContext(bool packrat) : packrat(packrat) {}
+
+bool ParserContext::is_packrat() const {
+    return packrat;
+}
+
+std::size_t ParserContext::memo_hits() const {
+    return hits;
+}
+
+std::size_t ParserContext::memo_misses() const {
+    return misses;
+}
+
+void ParserContext::begin_parse() {
+    memo_tables.clear();
+    depth = 0;
+    nesting = 0;
+    suspended = 0;
+    failure_position = 0;
+    failure_expected = TokenSet();
+}
+
+internal::MemoTableBase* ParserContext::memo_table(std::size_t rule_id) const {
+    for(auto const& [id, table] : memo_tables)
+        if (id == rule_id)
+            return table.get();
+    return nullptr;
+}
+
+internal::MemoTableBase& ParserContext::set_memo_table(std::size_t rule_id, std::unique_ptr<internal::MemoTableBase> table) {
+    for(auto& [id, existing] : memo_tables)
+        if (id == rule_id)
+            return *(existing = std::move(table));
+    memo_tables.emplace_back(rule_id, std::move(table));
+    return *memo_tables.back().second;
+}
+
+void ParserContext::memo_hit() {
+    ++hits;
+}
+
+void ParserContext::memo_miss() {
+    ++misses;
+}
+
+TraceSink* ParserContext::trace_sink() const {
+    return sink;
+}
+
+void ParserContext::set_trace_sink(TraceSink* sink) {
+    this->sink = sink;
+}
+
+std::size_t& ParserContext::trace_depth() {
+    return depth;
+}
+
+std::size_t& ParserContext::nesting_depth() {
+    return nesting;
+}
+
+void ParserContext::expect(TokenSet tokens, std::size_t position) {
+    if (suspended > 0)
+        return;
+    if (position > failure_position) {
+        failure_position = position;
+        failure_expected = tokens;
+    } else if (position == failure_position) {
+        failure_expected = failure_expected | tokens;
+    }
+}
+
+void ParserContext::suspend_expectations() {
+    ++suspended;
+}
+
+void ParserContext::resume_expectations() {
+    --suspended;
+}
+
+ParserError ParserContext::furthest_failure() const {
+    return ParserError::expected(failure_expected, failure_position);
+}
+
+}
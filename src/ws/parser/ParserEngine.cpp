@@ -0,0 +1,148 @@
+#include <ws/parser/ParserEngine.hpp>
+#include <ws/parser/ParserStatic.hpp>
+#include <ws/parser/token/TokenStream.hpp>
+
+#include <ws/parser/ast/AST.hpp>
+#include <ws/parser/ast/Number.hpp>
+#include <ws/parser/ast/BinaryOperator.hpp>
+#include <ws/parser/ast/UnaryOperator.hpp>
+#include <module/module.h>
+
+namespace ws::parser {
+
+AST_ptr term_to_AST(std::variant<std::tuple<TokenRef, AST_ptr>, TokenRef, /*std::tuple<TokenRef, AST_ptr, TokenRef>>*/ AST_ptr> expr) {
+    switch(expr.index()) {
+    case 0: // std::tuple<TokenRef, AST_ptr>
+        return std::make_unique<UnaryOperator>("negate", std::move(std::get<1>(std::get<0>(expr))));
+    case 1: // TokenRef
+        return std::make_unique<Number>(std::string(std::get<1>(expr).content()), std::get<1>(expr).value());
+    case 2: // std::tuple<TokenRef, AST_ptr, TokenRef>
+        return std::move(std::get<2>(expr));
+    default:
+        ws::module::errorln("WTF ? term_to_AST::expr should have an index of 0, 1 or 2... What is going on ?");
+        return nullptr;
+    }
+}
+
+AST_ptr binary_to_AST(AST_ptr lhs, TokenRef op, AST_ptr rhs) {
+    return std::make_unique<BinaryOperator>(op.kind(), std::move(lhs), std::move(rhs));
+}
+
+
+
+
+/*
+ * Grammar
+ *    Owns the whole combinator graph, the recursive rules reference 'expr' and 'term', so it must never move once built
+ */
+struct ParserEngine::Grammar {
+
+    explicit Grammar(std::size_t max_depth);
+
+    Grammar(Grammar const&) = delete;
+    Grammar& operator=(Grammar const&) = delete;
+
+    ct::Rule<AST_ptr> input;
+    ct::Rule<AST_ptr> expr;
+    ct::Rule<AST_ptr> term;
+
+};
+
+ParserEngine::Grammar::Grammar(std::size_t max_depth) {
+    using namespace ct;
+
+    /*
+     * input := expr <end of stream>
+     * expr := factor  (('-' | '+') factor)*
+     * factor := term (('*' | '/') term)*
+     * term := '-' term | float | '(' expr ')'
+     */
+
+    auto float_eater     = log("float", eat(TokenType::Literal,     TokenSubType::Float));
+    auto minus_eater     = log("'-'",   eat(TokenType::Operator,    TokenSubType::Minus));
+    auto left_par_eater  = log("'('",   eat(TokenType::Parenthesis, TokenSubType::Left));
+    auto right_par_eater = log("')'",   eat(TokenType::Parenthesis, TokenSubType::Right));
+
+    // A single mask test for each level of operators
+
+    auto factor_operators = log(
+        "'*' | '/'",
+        one_of(TokenSet::of(TokenType::Operator, TokenSubType::Multiplication) | TokenSet::of(TokenType::Operator, TokenSubType::Division)));
+
+    auto expr_operators = log(
+        "'+' | '-'",
+        one_of(TokenSet::of(TokenType::Operator, TokenSubType::Plus) | TokenSet::of(TokenType::Operator, TokenSubType::Minus)));
+
+    // The recursion goes through these two, each one opens a level of nesting
+
+    auto term_negate = nested(max_depth, log(
+        "'-' term", 
+        minus_eater & ~term));
+
+    // Nothing else can start with '(', so a failure after it is final
+    auto term_parentherized_expr = nested(max_depth, log(
+        "'(' expr ')'", 
+        left_par_eater > commit(~expr < right_par_eater)));
+
+    // Not memoized: the alternatives are chosen on their first token, nothing is parsed twice at the same position,
+    // so a memo table would only cost its allocation and a copy of each AST
+    term = log("term as AST", map(term_to_AST, log(
+        "term := '-' term | float | '(' expr ')'", 
+        term_negate | float_eater | term_parentherized_expr)));
+
+    // The operator chains are folded into left associated BinaryOperator while they are parsed
+
+    auto factor = log(
+        "factor := term (('*' | '/') term)*",
+        chainl1(~term, factor_operators, binary_to_AST));
+
+    expr = log(
+        "expr := factor (('+' | '-') factor)*",
+        chainl1(factor, expr_operators, binary_to_AST));
+
+    // The end of the stream is only tested, there is no token to consume
+    input = ~expr < lookahead(1, TokenSet::end_of_stream());
+}
+
+
+
+ParserEngine::ParserEngine(std::size_t max_depth) : grammar(std::make_unique<Grammar>(max_depth)), depth_budget(max_depth) {}
+
+ParserEngine::~ParserEngine() = default;
+
+ParserEngine::ParserEngine(ParserEngine&&) noexcept = default;
+
+ParserEngine& ParserEngine::operator=(ParserEngine&&) noexcept = default;
+
+std::size_t ParserEngine::max_depth() const {
+    return depth_budget;
+}
+
+ParserResult ParserEngine::parse(TokenView const& tokens) const {
+    return parse(tokens, 0, tokens.size());
+}
+
+ParserResult ParserEngine::parse(TokenView const& tokens, ParserContext& context) const {
+    return parse(tokens, 0, tokens.size(), context);
+}
+
+ParserResult ParserEngine::parse(TokenView const& tokens, std::size_t begin, std::size_t end) const {
+    ParserContext context;
+    return parse(tokens, begin, end, context);
+}
+
+ParserResult ParserEngine::parse(TokenView const& tokens, std::size_t begin, std::size_t end, ParserContext& context) const {
+    context.begin_parse();
+
+    TokenStream it(tokens, begin, end, &context);
+    auto res = grammar->input(it);
+    if (!has_failed(res))
+        return std::move(std::get<AST_ptr>(res));
+
+    // Too deep is not a token missing, the furthest failure does not know about it
+    if (auto const& error = std::get<ParserError>(res); error.kind() == ParserError::Kind::TooDeep)
+        return locate(error, tokens, begin, end);
+    return locate(context.furthest_failure(), tokens, begin, end);
+}
+
+}
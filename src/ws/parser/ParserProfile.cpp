@@ -0,0 +1,107 @@
+#include <ws/parser/ParserProfile.hpp>
+
+#include <algorithm>
+#include <iomanip>
+
+namespace ws::parser {
+
+std::size_t ProfileSink::rule_of(std::string const* name) {
+    if (auto it = by_address.find(name); it != by_address.end())
+        return it->second;
+
+    auto [it, inserted] = by_name.emplace(*name, profiles.size());
+    if (inserted) {
+        profiles.emplace_back();
+        profiles.back().name = *name;
+        active.emplace_back(0);
+    }
+    by_address.emplace(name, it->second);
+    return it->second;
+}
+
+void ProfileSink::record(TraceEvent const& event, TraceValue const&) {
+    auto now = clock::now();
+
+    if (event.kind == TraceEvent::Kind::Begin) {
+        auto rule = rule_of(event.rule);
+        ++profiles[rule].invocations;
+        ++active[rule];
+        frames.push_back({rule, event.position, now});
+        return;
+    }
+
+    if (frames.empty())
+        return;
+
+    auto frame = frames.back();
+    frames.pop_back();
+
+    auto& profile = profiles[frame.rule];
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - frame.begin);
+    auto consumed = event.position > frame.position ? event.position - frame.position : 0;
+
+    if (event.kind == TraceEvent::Kind::Success) {
+        ++profile.successes;
+        profile.tokens += consumed;
+    } else {
+        ++profile.failures;
+        if (consumed > 0)
+            ++profile.backtracks;
+    }
+
+    profile.self += elapsed - frame.children;
+    if (--active[frame.rule] == 0)
+        profile.cumulative += elapsed;
+    if (!frames.empty())
+        frames.back().children += elapsed;
+}
+
+std::vector<RuleProfile> ProfileSink::rules() const {
+    auto sorted = profiles;
+    std::stable_sort(sorted.begin(), sorted.end(), [] (RuleProfile const& a, RuleProfile const& b) {
+        return a.self > b.self;
+    });
+    return sorted;
+}
+
+void ProfileSink::clear() {
+    profiles.clear();
+    active.clear();
+    by_address.clear();
+    by_name.clear();
+    frames.clear();
+}
+
+void ProfileSink::print_table(std::ostream& os) const {
+    auto us = [] (std::chrono::nanoseconds ns) { return static_cast<double>(ns.count()) / 1000.; };
+
+    os << std::setw(10) << "calls" << std::setw(10) << "success" << std::setw(10) << "failure" 
+       << std::setw(10) << "tokens" << std::setw(12) << "backtracks" 
+       << std::setw(14) << "total (us)" << std::setw(14) << "self (us)" << "  rule\n";
+
+    auto flags = os.flags();
+    os << std::fixed << std::setprecision(1);
+    for(auto const& rule : rules())
+        os << std::setw(10) << rule.invocations << std::setw(10) << rule.successes << std::setw(10) << rule.failures 
+           << std::setw(10) << rule.tokens << std::setw(12) << rule.backtracks
+           << std::setw(14) << us(rule.cumulative) << std::setw(14) << us(rule.self) << "  " << rule.name << '\n';
+    os.flags(flags);
+}
+
+nlohmann::json ProfileSink::to_json() const {
+    auto json = nlohmann::json::array();
+    for(auto const& rule : rules())
+        json.push_back({
+            {"rule", rule.name},
+            {"invocations", rule.invocations},
+            {"successes", rule.successes},
+            {"failures", rule.failures},
+            {"tokens", rule.tokens},
+            {"backtracks", rule.backtracks},
+            {"cumulative_ns", rule.cumulative.count()},
+            {"self_ns", rule.self.count()}
+        });
+    return json;
+}
+
+}
@@ -1,29 +1,95 @@
+#include <sstream>
+
 #include <ws/parser/ParserResult.hpp>
 
 namespace ws::parser {
 
-ParserError ParserError::expected(std::vector<std::string> const& tokens) {
-    std::string error = "Excepted one of ";
-    for(std::size_t i = 0; i < tokens.size(); ++i) {
-        if (i > 0)
-            error += ", ";
-        error += '`' + tokens[i] + "`";
-    }
-    return { error };
+ParserError ParserError::expected(TokenSet tokens, std::size_t position) {
+    return { Kind::Expected, tokens, position };
+}
+
+ParserError ParserError::unknown_token(std::size_t position) {
+    return { Kind::UnknownToken, TokenSet(), position };
+}
+
+ParserError ParserError::too_deep(std::size_t position) {
+    return { Kind::TooDeep, TokenSet(), position };
+}
+
+ParserError ParserError::error(std::size_t position) {
+    return { Kind::Unknown, TokenSet(), position };
+}
+
+ParserError::Kind ParserError::kind() const {
+    return error_kind;
+}
+
+std::size_t ParserError::position() const {
+    return error_position;
 }
-ParserError ParserError::unknown_token(std::string const& token) {
-    return {"Unknown token `" + token + "`"};
+
+TokenSet ParserError::expected_tokens() const {
+    return expected_set;
+}
+
+ParserError ParserError::at(std::size_t line, std::size_t column) const {
+    ParserError located = *this;
+    located.error_line = line;
+    located.error_column = column;
+    return located;
+}
+
+std::size_t ParserError::line() const {
+    return error_line;
+}
+
+std::size_t ParserError::column() const {
+    return error_column;
+}
+
+ParserError ParserError::committed() const {
+    ParserError error = *this;
+    error.cut = true;
+    return error;
 }
 
-ParserError ParserError::error() {
-    return {"Unknown error"};
+bool ParserError::is_committed() const {
+    return cut;
 }
 
 std::string ParserError::what() const {
-    return error_msg;
+    std::ostringstream os;
+    switch(error_kind) {
+        case Kind::Expected:
+            os << "Excepted one of " << expected_set;
+            break;
+        case Kind::UnknownToken:
+            os << "Unknown token";
+            break;
+        case Kind::TooDeep:
+            os << "Nested deeper than the budget of the parser";
+            break;
+        default:
+            os << "Unknown error";
+            break;
+    }
+    if (error_line != 0)
+        os << " at " << error_line << ':' << error_column;
+    else if (error_position != unknown_position)
+        os << " at token " << error_position;
+    return os.str();
 }
 
-ParserError::ParserError(std::string const& error_msg) : error_msg(error_msg) {}
+ParserError::ParserError(Kind kind, TokenSet expected, std::size_t position) 
+    : error_kind(kind), expected_set(expected), error_position(position) {}
+
+ParserError locate(ParserError const& error, TokenView const& tokens, std::size_t begin, std::size_t end) {
+    if (error.position() < end - begin)
+        return error.at(tokens.line(begin + error.position()), tokens.column(begin + error.position()));
+    if (end > begin)
+        return error.at(tokens.line(end - 1), tokens.column(end - 1) + tokens.content(end - 1).size());
+    return error.at(1, 1);
+}
 
 bool is_error(ParserResult const& res) {
     return get_error(res) != nullptr;
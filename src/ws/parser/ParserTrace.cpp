@@ -0,0 +1,79 @@
+#include <ws/parser/ParserTrace.hpp>
+
+#include <module/module.h>
+
+#include <algorithm>
+
+namespace ws::parser {
+
+std::ostream& operator<<(std::ostream& os, TraceValue const& value) {
+    if (value.print)
+        value.print(os, value.object);
+    return os;
+}
+
+std::ostream& operator<<(std::ostream& os, TraceEvent const& event) {
+    os << std::string(event.depth * 2, ' ') << "• ";
+    switch(event.kind) {
+        case TraceEvent::Kind::Begin: os << "Begin <" << *event.rule << ">"; break;
+        case TraceEvent::Kind::Success: os << "<" << *event.rule << "> succeed"; break;
+        case TraceEvent::Kind::Failure: os << "<" << *event.rule << "> failed"; break;
+        case TraceEvent::Kind::Exception: os << "<" << *event.rule << "> threw an exception"; break;
+    }
+    return os << " at token " << event.position;
+}
+
+
+
+void ConsoleTraceSink::record(TraceEvent const& event, TraceValue const& value) {
+    auto spaces = ws::module::spaces(event.depth * 2);
+    switch(event.kind) {
+        case TraceEvent::Kind::Begin:
+            ws::module::noticeln(spaces, "• Begin <", ws::module::style::bold, *event.rule, ws::module::style::reset, ">");
+            break;
+        case TraceEvent::Kind::Success:
+            ws::module::successln(
+                spaces, 
+                "• <", ws::module::style::bold, *event.rule, ws::module::style::reset, "> succeed: ", 
+                ws::module::colour::fg::cyan, value);
+            break;
+        case TraceEvent::Kind::Failure:
+            ws::module::warnln(spaces, "• <", ws::module::style::bold, *event.rule, ws::module::style::reset, "> failed: ", value);
+            break;
+        case TraceEvent::Kind::Exception:
+            ws::module::warnln(spaces, "• <", ws::module::style::bold, *event.rule, ws::module::style::reset, "> threw an exception");
+            break;
+    }
+}
+
+
+
+RingTraceSink::RingTraceSink(std::size_t capacity) : buffer(capacity) {}
+
+void RingTraceSink::record(TraceEvent const& event, TraceValue const&) {
+    if (buffer.empty())
+        return;
+    buffer[next] = event;
+    next = (next + 1) % buffer.size();
+    ++count;
+}
+
+std::vector<TraceEvent> RingTraceSink::events() const {
+    auto size = std::min(count, buffer.size());
+    std::vector<TraceEvent> events;
+    events.reserve(size);
+    for(std::size_t i = 0; i < size; ++i)
+        events.emplace_back(buffer[(next + buffer.size() - size + i) % buffer.size()]);
+    return events;
+}
+
+std::size_t RingTraceSink::dropped() const {
+    return count - std::min(count, buffer.size());
+}
+
+void RingTraceSink::clear() {
+    next = 0;
+    count = 0;
+}
+
+}
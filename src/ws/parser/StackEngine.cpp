@@ -0,0 +1,43 @@
+#include <ws/parser/StackEngine.hpp>
+
+namespace ws::parser {
+
+StackEngine::StackEngine(std::size_t max_depth) : StackEngine(OperatorTable::calculator(), max_depth) {}
+
+StackEngine::StackEngine(OperatorTable table, std::size_t max_depth) 
+    : table(std::make_shared<OperatorTable const>(std::move(table))), depth_budget(max_depth) {}
+
+std::size_t StackEngine::max_depth() const {
+    return depth_budget;
+}
+
+IncrementalParser StackEngine::incremental() const {
+    return IncrementalParser(table, depth_budget);
+}
+
+ParserResult StackEngine::parse(TokenView const& tokens) const {
+    return parse(tokens, 0, tokens.size());
+}
+
+ParserResult StackEngine::parse(TokenView const& tokens, ParserContext& context) const {
+    return parse(tokens, 0, tokens.size(), context);
+}
+
+ParserResult StackEngine::parse(TokenView const& tokens, std::size_t begin, std::size_t end) const {
+    ParserContext context;
+    return parse(tokens, begin, end, context);
+}
+
+ParserResult StackEngine::parse(TokenView const& tokens, std::size_t begin, std::size_t end, ParserContext& context) const {
+    context.begin_parse();
+
+    auto parser = incremental();
+    parser.feed(tokens, begin, end);
+    auto res = parser.finish();
+
+    if (auto error = get_error(res); error && error->kind() == ParserError::Kind::Expected)
+        context.expect(error->expected_tokens(), error->position());
+    return res;
+}
+
+}
@@ -1,9 +1,34 @@
 #include <ws/parser/ast/BinaryOperator.hpp>
 
+#include <cassert>
+
 namespace ws::parser {
 
+namespace {
+
+std::string name_of(TokenKind op) {
+    switch(op) {
+    case TokenKind::OperatorPlus:
+        return "plus";
+    case TokenKind::OperatorMinus:
+        return "subtract";
+    case TokenKind::OperatorMultiplication:
+        return "multiplication";
+    case TokenKind::OperatorDivision:
+        return "division";
+    default:
+        // The grammars only give the four operators above, another table names its operators itself
+        assert(false && "BinaryOperator: the kind is not a binary operator");
+        return "";
+    }
+}
+
+}
+
 BinaryOperator::BinaryOperator(std::string const& name, std::unique_ptr<AST> lhs, std::unique_ptr<AST> rhs) : name(name), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
 
+BinaryOperator::BinaryOperator(TokenKind op, std::unique_ptr<AST> lhs, std::unique_ptr<AST> rhs) : BinaryOperator(name_of(op), std::move(lhs), std::move(rhs)) {}
+
 nlohmann::json BinaryOperator::compile() const {
     return {
         {"type", "operator." + name},
@@ -22,4 +47,8 @@ std::ostream& BinaryOperator::dump(std::ostream& os) const {
     return os << '(' << *lhs << ' ' << symbol << ' ' << *rhs << ')';
 }
 
+std::unique_ptr<AST> BinaryOperator::clone() const {
+    return std::make_unique<BinaryOperator>(name, lhs->clone(), rhs->clone());
+}
+
 }
\ No newline at end of file
@@ -2,17 +2,25 @@
 
 namespace ws::parser {
 
-Number::Number(std::string const& value) : value(value) {}
+Number::Number(std::string const& text, double value) : text(text), number(value) {}
 
 nlohmann::json Number::compile() const {
     return {
         {"type", "literal.float"},
-        {"value", value}
+        {"value", text}
     };
 }
 
 std::ostream& Number::dump(std::ostream& os) const {
-    return os << value;
+    return os << text;
+}
+
+std::unique_ptr<AST> Number::clone() const {
+    return std::make_unique<Number>(text, number);
+}
+
+double Number::value() const {
+    return number;
 }
 
 }
\ No newline at end of file
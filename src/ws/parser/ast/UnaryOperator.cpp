@@ -18,4 +18,8 @@ std::ostream& UnaryOperator::dump(std::ostream& os) const {
     return os << symbol << *operand;
 }
 
+std::unique_ptr<AST> UnaryOperator::clone() const {
+    return std::make_unique<UnaryOperator>(name, operand->clone());
+}
+
 }
\ No newline at end of file
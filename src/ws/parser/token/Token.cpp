@@ -1,12 +1,89 @@
 #include <ws/parser/token/Token.hpp>
+#include <ws/parser/token/TokenRef.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
 
 namespace ws::parser {
 
+Token::Token(std::string const& content, TokenKind kind, std::size_t line, std::size_t column) 
+    : content(content), kind(kind), value(literal_value(kind, content)), line(line), column(column) {}
+
 Token::Token(std::string const& content, TokenType type, TokenSubType subtype, std::size_t line, std::size_t column) 
-    : content(content), type(type), subtype(subtype), line(line), column(column) {}
+    : Token(content, kind_of(type, subtype), line, column) {}
+
+TokenType Token::type() const {
+    return type_of(kind);
+}
+
+TokenSubType Token::subtype() const {
+    return subtype_of(kind);
+}
 
 std::ostream& operator<<(std::ostream& os, Token const& token) {
-    return os << "{" << token.content << " : " << token.type << "." << token.subtype << " at " << token.line << ":" << token.column << "}";
+    return os << "{" << token.content << " : " << token.kind << " at " << token.line << ":" << token.column << "}";
+}
+
+std::ostream& operator<<(std::ostream& os, TokenRef token) {
+    return os << "{" << token.content() << " : " << token.kind() << " at " << token.line() << ":" << token.column() << "}";
+}
+
+namespace {
+
+/*
+ * from_chars gives result_out_of_range for the numerals too large and for the ones that round to 0,
+ * the order of magnitude of the first significant digit tells them apart
+ * The numeral is already checked by from_chars, only its digits and its exponent are read
+ */
+bool underflows(std::string_view numeral) {
+    if (!numeral.empty() && numeral[0] == '-')
+        numeral.remove_prefix(1);
+    auto mantissa = numeral.substr(0, numeral.find_first_of("eE"));
+
+    auto integer = mantissa.substr(0, mantissa.find('.'));
+    auto leading_zeros = std::min(integer.find_first_not_of('0'), integer.size());
+    long long magnitude;
+    if (leading_zeros < integer.size()) {
+        magnitude = static_cast<long long>(integer.size() - leading_zeros) - 1;
+    } else {
+        auto fraction = mantissa.substr(std::min(integer.size() + 1, mantissa.size()));
+        magnitude = -static_cast<long long>(std::min(fraction.find_first_not_of('0'), fraction.size())) - 1;
+    }
+
+    // The exponent saturates, past the range of a double the order of magnitude of the mantissa does not matter anymore
+    long long exponent = 0;
+    if (mantissa.size() < numeral.size()) {
+        auto digits = numeral.substr(mantissa.size() + 1);
+        bool negative = !digits.empty() && digits[0] == '-';
+        if (!digits.empty() && (digits[0] == '-' || digits[0] == '+'))
+            digits.remove_prefix(1);
+        for(auto c : digits)
+            exponent = std::min(exponent * 10 + (c - '0'), 1'000'000'000'000LL);
+        if (negative)
+            exponent = -exponent;
+    }
+    return magnitude + exponent < 0;
+}
+
+}
+
+std::optional<double> read_float(std::string_view content) {
+    double value;
+    auto [end, error] = std::from_chars(content.data(), content.data() + content.size(), value);
+    if (end != content.data() + content.size())
+        return std::nullopt;
+    if (error == std::errc::result_out_of_range && underflows(content))
+        return content[0] == '-' ? -0. : 0.;
+    if (error != std::errc() || !std::isfinite(value))
+        return std::nullopt;
+    return value;
+}
+
+std::optional<double> literal_value(TokenKind kind, std::string_view content) {
+    if (kind != TokenKind::LiteralFloat)
+        return 0.;
+    return read_float(content);
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include <ws/parser/token/TokenBuffer.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <utility>
+
+namespace ws::parser {
+
+TokenBuffer::TokenBuffer(std::vector<Token> const& tokens) {
+    reserve(tokens.size());
+    for(auto const& token : tokens) {
+        [[maybe_unused]] bool pushed = push_back(token);
+        assert(pushed && "TokenBuffer: a literal is not a numeral, or the tokens exceed the pool or the offsets");
+    }
+}
+
+TokenBuffer::TokenBuffer(std::string_view source) {
+    columns.source = source;
+}
+
+TokenBuffer::TokenBuffer(TokenBuffer const& other) : TokenView(other), kinds(other.kinds), contents(other.contents), offsets(other.offsets),
+    line_starts(other.line_starts), end_offset(other.end_offset), pool(other.pool) {
+    refresh();
+}
+
+TokenBuffer::TokenBuffer(TokenBuffer&& other) noexcept : TokenView(other), kinds(std::move(other.kinds)), contents(std::move(other.contents)),
+    offsets(std::move(other.offsets)), line_starts(std::move(other.line_starts)), end_offset(other.end_offset),
+    pool(std::move(other.pool)) {
+    refresh();
+    other.clear();
+}
+
+TokenBuffer& TokenBuffer::operator=(TokenBuffer const& other) {
+    TokenView::operator=(other);
+    kinds = other.kinds;
+    contents = other.contents;
+    offsets = other.offsets;
+    line_starts = other.line_starts;
+    end_offset = other.end_offset;
+    pool = other.pool;
+    refresh();
+    return *this;
+}
+
+TokenBuffer& TokenBuffer::operator=(TokenBuffer&& other) noexcept {
+    TokenView::operator=(other);
+    kinds = std::move(other.kinds);
+    contents = std::move(other.contents);
+    offsets = std::move(other.offsets);
+    line_starts = std::move(other.line_starts);
+    end_offset = other.end_offset;
+    pool = std::move(other.pool);
+    refresh();
+    other.clear();
+    return *this;
+}
+
+void TokenBuffer::reserve(std::size_t count, std::size_t content_size) {
+    kinds.reserve(count);
+    contents.reserve(count);
+    offsets.reserve(count);
+    pool.reserve(content_size);
+    refresh();
+}
+
+bool TokenBuffer::push_back(std::string_view content, TokenType type, TokenSubType subtype, std::size_t line, std::size_t column) {
+    return push_back(content, kind_of(type, subtype), line, column);
+}
+
+bool TokenBuffer::push_back(std::string_view content, TokenKind kind, std::size_t line, std::size_t column) {
+    if (!literal_value(kind, content) || !fits_in_pool(pool.size(), content.size()) || !is_reachable(line, column))
+        return false;
+    kinds.push_back(kind);
+    contents.push_back({static_cast<std::uint32_t>(pool.size()), static_cast<std::uint32_t>(content.size())});
+    offsets.push_back(offset_of(line, column));
+    pool.append(content);
+    refresh();
+    return true;
+}
+
+bool TokenBuffer::push_back(Token const& token) {
+    // The value is already checked
+    if (!token.value || !fits_in_pool(pool.size(), token.content.size()) || !is_reachable(token.line, token.column))
+        return false;
+    kinds.push_back(token.kind);
+    contents.push_back({static_cast<std::uint32_t>(pool.size()), static_cast<std::uint32_t>(token.content.size())});
+    offsets.push_back(offset_of(token.line, token.column));
+    pool.append(token.content);
+    refresh();
+    return true;
+}
+
+bool TokenBuffer::push_back_view(std::size_t offset, std::size_t length, TokenKind kind, std::size_t line, std::size_t column) {
+    if (!fits_in_source(columns.source.size(), offset, length))
+        return false;
+    if (!literal_value(kind, columns.source.substr(offset, length)) || !is_reachable(line, column))
+        return false;
+    kinds.push_back(kind);
+    contents.push_back({static_cast<std::uint32_t>(offset) | in_source, static_cast<std::uint32_t>(length)});
+    offsets.push_back(offset_of(line, column));
+    refresh();
+    return true;
+}
+
+void TokenBuffer::clear() {
+    kinds.clear();
+    contents.clear();
+    offsets.clear();
+    line_starts.clear();
+    end_offset = 0;
+    pool.clear();
+    refresh();
+}
+
+// The contents of the pool end before the 'in_source' bit, so their offsets and their lengths fit in 31 bits
+bool TokenBuffer::fits_in_pool(std::size_t used, std::size_t length) {
+    return used < in_source && length < in_source - used;
+}
+
+// The view is in the source, its offset leaves the 'in_source' bit free and its length fits in 32 bits
+bool TokenBuffer::fits_in_source(std::size_t source_size, std::size_t offset, std::size_t length) {
+    return offset <= source_size && length <= source_size - offset
+        && offset < in_source && length <= std::numeric_limits<std::uint32_t>::max();
+}
+
+void TokenBuffer::refresh() {
+    columns.size = kinds.size();
+    columns.kinds = kinds.data();
+    columns.contents = contents.data();
+    columns.offsets = offsets.data();
+    columns.line_starts = line_starts.data();
+    columns.line_count = line_starts.size();
+    columns.pool = pool.data();
+}
+
+bool TokenBuffer::is_reachable(std::size_t line, std::size_t column) const {
+    return offset_at(line, column).has_value();
+}
+
+/*
+ * The tokens come with a line and a column, not with an offset in their source:
+ * when a token is on another line than the previous one, its line starts after all the offsets given so far
+ * So the line starts are increasing, one per run of tokens on the same line, and the lines can come in any order
+ * The line must fit in 32 bits, and the offset too with the one after it, that is the start of the next line
+ */
+std::optional<std::uint32_t> TokenBuffer::offset_at(std::size_t line, std::size_t column) const {
+    constexpr std::size_t max = std::numeric_limits<std::uint32_t>::max();
+    if (line > max)
+        return std::nullopt;
+    std::size_t start = line_starts.empty() || line_starts.back().line != line ? end_offset : line_starts.back().offset;
+    if (column >= max - start)
+        return std::nullopt;
+    return static_cast<std::uint32_t>(start + column);
+}
+
+// The position is reachable, see offset_at
+std::uint32_t TokenBuffer::offset_of(std::size_t line, std::size_t column) {
+    if (line_starts.empty() || line_starts.back().line != line)
+        line_starts.push_back({end_offset, static_cast<std::uint32_t>(line)});
+    auto offset = line_starts.back().offset + static_cast<std::uint32_t>(column);
+    end_offset = std::max(end_offset, offset + 1);
+    return offset;
+}
+
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <unordered_map>
 #include <sstream>
+#include <algorithm>
 
 namespace ws::parser {
 
@@ -52,6 +53,14 @@ std::string EmptyTokenType::what() const {
 
 
 
+InvalidJson::InvalidJson(std::string const& message) : message(message) {}
+
+std::string InvalidJson::what() const {
+    return "Invalid JSON, " + message;
+}
+
+
+
 UnreachablePosition::UnreachablePosition(std::string const& key, json_t::number_integer_t position)
     : key(key), position(position)
 {
@@ -64,6 +73,31 @@ std::string UnreachablePosition::what() const {
 
 
 
+InvalidNumeral::InvalidNumeral(std::string const& content, std::size_t line, std::size_t column)
+    : content(content), line(line), column(column) {}
+
+std::string InvalidNumeral::what() const {
+    return "Float literal '" + content + "' at " + std::to_string(line) + ":" + std::to_string(column) + " is not a numeral";
+}
+
+
+
+ContentOutOfBounds::ContentOutOfBounds(std::size_t line, std::size_t column) : line(line), column(column) {}
+
+std::string ContentOutOfBounds::what() const {
+    return "Content of the token at " + std::to_string(line) + ":" + std::to_string(column) + " is past the 2 GiB of the token buffer";
+}
+
+
+
+PositionOutOfBounds::PositionOutOfBounds(std::size_t line, std::size_t column) : line(line), column(column) {}
+
+std::string PositionOutOfBounds::what() const {
+    return "Position " + std::to_string(line) + ":" + std::to_string(column) + " of the token is past the 32 bits offsets of the token buffer";
+}
+
+
+
 std::string type_as_string(json_t::value_t type) {
     switch (type) {
         case json_t::value_t::null:            return "null";
@@ -207,13 +241,16 @@ SingleTokenParserResult parse_token(json_t const& json) {
     if (auto* error = std::get_if<std::unique_ptr<TokenParsingError>>(&column); error)
         return std::move(*error);
     
-    return Token {
+    Token token {
         std::get<std::string>(content),
         std::get<std::pair<TokenType, TokenSubType>>(type).first,
         std::get<std::pair<TokenType, TokenSubType>>(type).second,
         std::get<std::size_t>(line),
         std::get<std::size_t>(column)
     };
+    if (!token.value)
+        return std::make_unique<InvalidNumeral>(token.content, token.line, token.column);
+    return token;
 }
 
 
@@ -222,7 +259,8 @@ TokenParserResult parse_tokens(json_t const& json) {
     if (!json.is_array())
         return std::make_unique<RootNotArray>();
 
-    std::vector<ws::parser::Token> tokens;
+    TokenBuffer tokens;
+    tokens.reserve(json.size());
 
     for(auto json_token : json) {
         auto res = ws::parser::parse_token(json_token);
@@ -232,13 +270,251 @@ TokenParserResult parse_tokens(json_t const& json) {
             return std::move(*err);
         }
 
-        tokens.emplace_back(*get_token(res));
+        if (auto const& token = *get_token(res); !tokens.push_back(token)) {
+            if (!tokens.is_reachable(token.line, token.column))
+                return std::make_unique<PositionOutOfBounds>(token.line, token.column);
+            return std::make_unique<ContentOutOfBounds>(token.line, token.column);
+        }
     }
     return tokens;
 }
 
 
 
+/*
+ * TokenReader
+ *    SAX handler of parse_tokens_in_place, gives the same tokens and the same errors as parse_tokens on the JSON document
+ *    The string literals of the input come in the same order as the string events, so the reader follows them in the input:
+ *    a literal as long as its value has no escape sequence, it is the value itself and the token content is a view of it
+ */
+class TokenReader : public nlohmann::json_sax<json_t> {
+public:
+
+    explicit TokenReader(std::string_view input) : input(input), tokens(input) {}
+
+    bool null() override {
+        value(json_t::value_t::null);
+        return !error;
+    }
+
+    bool boolean(bool) override {
+        value(json_t::value_t::boolean);
+        return !error;
+    }
+
+    bool number_integer(number_integer_t val) override {
+        if (auto field = value(json_t::value_t::number_integer); field)
+            field->integer = val;
+        return !error;
+    }
+
+    bool number_unsigned(number_unsigned_t val) override {
+        if (auto field = value(json_t::value_t::number_unsigned); field)
+            field->position = val;
+        return !error;
+    }
+
+    bool number_float(number_float_t, string_t const&) override {
+        value(json_t::value_t::number_float);
+        return !error;
+    }
+
+    bool string(string_t& val) override {
+        auto field = value(json_t::value_t::string);
+        auto begin = next_string();
+        if (field) {
+            field->is_view = cursor - 1 - begin == val.size();
+            field->offset = begin;
+            field->length = val.size();
+            if (!field->is_view)
+                field->value = val;
+        }
+        return !error;
+    }
+
+    bool key(string_t& val) override {
+        next_string();
+        if (depth == 2) {
+            field = val == "content" ? &content
+                : val == "type" ? &type
+                : val == "line" ? &line
+                : val == "column" ? &column
+                : nullptr;
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        if (depth == 1) {
+            content = type = line = column = Field();
+            field = nullptr;
+        } else {
+            value(json_t::value_t::object);
+        }
+        ++depth;
+        return !error;
+    }
+
+    bool end_object() override {
+        if (--depth == 1)
+            error = push_token();
+        return !error;
+    }
+
+    bool start_array(std::size_t) override {
+        if (depth != 0)
+            value(json_t::value_t::array);
+        ++depth;
+        return !error;
+    }
+
+    bool end_array() override {
+        --depth;
+        return true;
+    }
+
+    bool parse_error(std::size_t, std::string const&, nlohmann::detail::exception const& ex) override {
+        error = std::make_unique<InvalidJson>(ex.what());
+        return false;
+    }
+
+    TokenParserResult result() {
+        if (error)
+            return std::move(error);
+        return std::move(tokens);
+    }
+
+private:
+
+    // A key of a token, 'discarded' when it is missing
+    struct Field {
+        json_t::value_t type = json_t::value_t::discarded;
+        bool is_view = false;
+        std::size_t offset = 0;
+        std::size_t length = 0;
+        std::string value;
+        number_integer_t integer = 0;
+        number_unsigned_t position = 0;
+    };
+
+    // A value at the root is not an array, in the array it is not a token object, in a token it is the value of a key
+    Field* value(json_t::value_t value_type) {
+        if (depth == 0)
+            error = std::make_unique<RootNotArray>();
+        else if (depth == 1)
+            error = std::make_unique<MissingKey>("content");
+        else if (depth == 2 && field) {
+            field->type = value_type;
+            return field;
+        }
+        return nullptr;
+    }
+
+    // Move after the next string literal, returns the offset of its first character
+    std::size_t next_string() {
+        auto begin = input.find('"', cursor) + 1;
+        auto end = begin;
+        while(input[end] != '"')
+            end += input[end] == '\\' ? 2 : 1;
+        cursor = end + 1;
+        return begin;
+    }
+
+    std::string_view text(Field const& field) const {
+        return field.is_view ? input.substr(field.offset, field.length) : std::string_view(field.value);
+    }
+
+    std::unique_ptr<TokenParsingError> check_string(Field const& field, std::string const& key) const {
+        if (field.type == json_t::value_t::discarded)
+            return std::make_unique<MissingKey>(key);
+        if (field.type != json_t::value_t::string)
+            return std::make_unique<TypeMismatch>(key, type_as_string(json_t::value_t::string), type_as_string(field.type));
+        return nullptr;
+    }
+
+    std::unique_ptr<TokenParsingError> check_position(Field const& field, std::string const& key) const {
+        if (field.type == json_t::value_t::discarded)
+            return std::make_unique<MissingKey>(key);
+        if (field.type != json_t::value_t::number_integer && field.type != json_t::value_t::number_unsigned)
+            return std::make_unique<TypeMismatch>(key, type_as_string(json_t::value_t::number_integer), type_as_string(field.type));
+        if (field.type == json_t::value_t::number_integer)
+            return std::make_unique<UnreachablePosition>(key, field.integer);
+        return nullptr;
+    }
+
+    std::unique_ptr<TokenParsingError> push_token() {
+        if (auto err = check_string(content, "content"); err)
+            return err;
+        if (auto err = check_string(type, "type"); err)
+            return err;
+
+        // The known types are found without splitting them, the unknown ones get the errors of parse_type
+        static constexpr struct {
+            std::string_view name;
+            TokenKind kind;
+        } known_types[] = {
+            {"literal.float", TokenKind::LiteralFloat},
+            {"parenthesis.left", TokenKind::ParenthesisLeft},
+            {"parenthesis.right", TokenKind::ParenthesisRight},
+            {"operator.plus", TokenKind::OperatorPlus},
+            {"operator.minus", TokenKind::OperatorMinus},
+            {"operator.multiplication", TokenKind::OperatorMultiplication},
+            {"operator.division", TokenKind::OperatorDivision}
+        };
+
+        TokenKind kind;
+        auto known = std::find_if(std::begin(known_types), std::end(known_types), [&] (auto const& known) { return known.name == text(type); });
+        if (known != std::end(known_types)) {
+            kind = known->kind;
+        } else {
+            auto parsed = parse_type(json_t{{"type", std::string(text(type))}});
+            if (auto* err = std::get_if<std::unique_ptr<TokenParsingError>>(&parsed); err)
+                return std::move(*err);
+            auto [token_type, token_subtype] = std::get<std::pair<TokenType, TokenSubType>>(parsed);
+            kind = kind_of(token_type, token_subtype);
+        }
+
+        if (auto err = check_position(line, "line"); err)
+            return err;
+        if (auto err = check_position(column, "column"); err)
+            return err;
+
+        auto token_line = static_cast<std::size_t>(line.position);
+        auto token_column = static_cast<std::size_t>(column.position);
+        bool pushed = content.is_view
+            ? tokens.push_back_view(content.offset, content.length, kind, token_line, token_column)
+            : tokens.push_back(content.value, kind, token_line, token_column);
+        if (pushed)
+            return nullptr;
+        // Refused for a literal that is not a numeral or for a token past the limits, the numeral is only read again on failure
+        auto token_content = text(content);
+        if (!literal_value(kind, token_content))
+            return std::make_unique<InvalidNumeral>(std::string(token_content), token_line, token_column);
+        if (!tokens.is_reachable(token_line, token_column))
+            return std::make_unique<PositionOutOfBounds>(token_line, token_column);
+        return std::make_unique<ContentOutOfBounds>(token_line, token_column);
+    }
+
+    std::string_view input;
+    std::size_t cursor = 0;
+    std::size_t depth = 0;
+
+    Field content, type, line, column;
+    Field* field = nullptr;
+
+    TokenBuffer tokens;
+    std::unique_ptr<TokenParsingError> error;
+
+};
+
+TokenParserResult parse_tokens_in_place(std::string_view input) {
+    TokenReader reader(input);
+    json_t::sax_parse(nlohmann::detail::input_adapter(input.data(), input.size()), &reader);
+    return reader.result();
+}
+
+
+
 bool is_error(SingleTokenParserResult const& res) {
     return get_error(res) != nullptr;
 }
@@ -271,16 +547,16 @@ std::unique_ptr<TokenParsingError> const* get_error(TokenParserResult const& err
     return std::get_if<std::unique_ptr<TokenParsingError>>(&error);
 }
 
-std::vector<Token> const* get_tokens(TokenParserResult const& error) {
-    return std::get_if<std::vector<Token>>(&error);
+TokenBuffer const* get_tokens(TokenParserResult const& error) {
+    return std::get_if<TokenBuffer>(&error);
 }
 
 std::unique_ptr<TokenParsingError>* get_error(TokenParserResult& error) {
     return std::get_if<std::unique_ptr<TokenParsingError>>(&error);
 }
 
-std::vector<Token>* get_tokens(TokenParserResult& error) {
-    return std::get_if<std::vector<Token>>(&error);
+TokenBuffer* get_tokens(TokenParserResult& error) {
+    return std::get_if<TokenBuffer>(&error);
 }
 
 
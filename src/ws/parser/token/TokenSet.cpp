@@ -0,0 +1,29 @@
+#include <ws/parser/token/TokenSet.hpp>
+
+namespace ws::parser {
+
+std::ostream& operator<<(std::ostream& os, TokenSet set) {
+    if (set == TokenSet::all())
+        return os << "`any token`";
+
+    bool is_first = true;
+    auto separator = [&] () -> std::ostream& {
+        if (!is_first)
+            os << ", ";
+        is_first = false;
+        return os;
+    };
+
+    for(std::size_t i = 0; i < token_kind_count; ++i) {
+        auto kind = static_cast<TokenKind>(i);
+        if (set.intersects(TokenSet::of(kind)))
+            separator() << '`' << type_of(kind) << ' ' << subtype_of(kind) << '`';
+    }
+
+    if (set.intersects(TokenSet::end_of_stream()))
+        separator() << "`end of stream`";
+
+    return os;
+}
+
+}
@@ -1,21 +1,46 @@
 #include <ws/parser/token/TokenStream.hpp>
 
+#include <cassert>
+
 namespace ws::parser {
 
-TokenStream::TokenStream(TokenStream::iterator begin, TokenStream::iterator end) : begin(begin), end(end) {}
+TokenStream::TokenStream(TokenView const& tokens, ParserContext* context) 
+    : TokenStream(tokens, 0, tokens.size(), context) {}
+
+TokenStream::TokenStream(TokenView const& tokens, std::size_t begin, std::size_t end, ParserContext* context)
+    : tokens(&tokens), origin(begin), begin(begin), end(end), parser_context(context) {}
 
 bool TokenStream::is_end_of_stream() const {
     return begin == end;
 }
 
-Token const& TokenStream::operator*() const {
+std::size_t TokenStream::position() const {
+    return begin - origin;
+}
+
+std::size_t TokenStream::size() const {
+    return end - origin;
+}
+
+ParserContext* TokenStream::context() const {
+    return parser_context;
+}
+
+TokenSet TokenStream::peek() const {
     if (begin != end)
-        return *begin;
-    throw std::out_of_range("ouch");
+        return TokenSet::of(tokens->kind(begin));
+    return TokenSet::end_of_stream();
 }
 
-Token const* TokenStream::operator->() const {
-    return &**this;
+TokenSet TokenStream::peek(std::size_t offset) const {
+    if (offset < end - begin)
+        return TokenSet::of(tokens->kind(begin + offset));
+    return TokenSet::end_of_stream();
+}
+
+TokenRef TokenStream::token() const {
+    assert(begin != end && "TokenStream: no token at the end of the stream, peek before");
+    return TokenRef(*tokens, begin);
 }
 
 TokenStream& TokenStream::operator++() {
@@ -41,4 +66,4 @@ TokenStream TokenStream::operator--(int) {
 }
 
 
-}
\ No newline at end of file
+}
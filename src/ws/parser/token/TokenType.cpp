@@ -24,4 +24,8 @@ std::ostream& operator<<(std::ostream& os, TokenSubType subtype) {
     }
 }
 
+std::ostream& operator<<(std::ostream& os, TokenKind kind) {
+    return os << type_of(kind) << '.' << subtype_of(kind);
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include <ws/parser/token/TokenView.hpp>
+
+#include <algorithm>
+
+namespace ws::parser {
+
+bool TokenView::has_valid_line_starts(Columns const& columns) {
+    if (columns.line_count == 0)
+        return columns.size == 0;
+    if (columns.line_starts[0].offset != 0)
+        return false;
+    for(std::size_t i = 1; i < columns.line_count; ++i)
+        if (columns.line_starts[i].offset <= columns.line_starts[i - 1].offset)
+            return false;
+    return true;
+}
+
+TokenView::Position TokenView::position(std::size_t index) const {
+    auto offset = columns.offsets[index];
+    auto start = std::upper_bound(columns.line_starts, columns.line_starts + columns.line_count, offset, 
+        [] (std::uint32_t offset, LineStart const& start) { return offset < start.offset; });
+    // No line start at or before the offset, only with invalid line starts
+    if (start == columns.line_starts)
+        return {0, offset};
+    --start;
+    return {start->line, offset - start->offset};
+}
+
+Token TokenView::token(std::size_t index) const {
+    return Token(std::string(content(index)), kind(index), line(index), column(index));
+}
+
+}
\ No newline at end of file
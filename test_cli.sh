@@ -0,0 +1,45 @@
+#!/bin/bash
+# Run the parser executable on generated token streams, it must exit normally whatever the nesting of the input
+# Usage: ./test_cli.sh <parser executable>
+
+parser=$1
+all_pass=0
+
+# tokens <depth>: 'depth' '(', a float, then 'depth' ')', in the JSON format read by the parser
+tokens() {
+    awk -v depth="$1" 'BEGIN {
+        column = 1
+        printf "["
+        for(i = 0; i < depth; ++i)
+            printf "{\"content\": \"(\", \"type\": \"parenthesis.left\", \"line\": 1, \"column\": %d}, ", column++
+        printf "{\"content\": \"1\", \"type\": \"literal.float\", \"line\": 1, \"column\": %d}", column++
+        for(i = 0; i < depth; ++i)
+            printf ", {\"content\": \")\", \"type\": \"parenthesis.right\", \"line\": 1, \"column\": %d}", column++
+        printf "]"
+    }'
+}
+
+# check <depth> <expected exit code> <expected message or ''> [parser arguments...]
+check() {
+    local depth=$1 expected_code=$2 expected_message=$3
+    shift 3
+
+    local output code
+    output=$(tokens "$depth" | "$parser" "$@" 2>&1)
+    code=$?
+
+    echo -n "Run the parser${*:+ $*} on $depth nested parenthesis... "
+    if [ "$code" -eq "$expected_code" ] && { [ -z "$expected_message" ] || grep -q "$expected_message" <<< "$output"; }; then
+        echo "OK"
+    else
+        echo "ERROR: exit code $code"
+        all_pass=1
+    fi
+}
+
+check 10 0 ''
+check 5000 0 ''
+check 100000 1 'Nested deeper than the budget of the parser at 1:10001'
+check 100000 1 'Nested deeper than the budget of the parser at 1:1001' --profile
+
+exit $all_pass